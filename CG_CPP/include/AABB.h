@@ -0,0 +1,134 @@
+#ifndef AABB_H
+#define AABB_H
+
+#include "Vector3.h"
+#include "Ray.h"
+#include "RayPacket.h"
+#include <algorithm>
+#include <limits>
+
+// CAIXA ALINHADA AOS EIXOS (Axis-Aligned Bounding Box)
+// Usada como volume envolvente pela BVH
+class AABB {
+public:
+    Vector3 minPoint;
+    Vector3 maxPoint;
+
+    // Caixa vazia (min = +inf, max = -inf): expandir a partir dela funciona direto
+    AABB()
+        : minPoint(std::numeric_limits<double>::infinity(),
+                   std::numeric_limits<double>::infinity(),
+                   std::numeric_limits<double>::infinity()),
+          maxPoint(-std::numeric_limits<double>::infinity(),
+                   -std::numeric_limits<double>::infinity(),
+                   -std::numeric_limits<double>::infinity()) {}
+
+    AABB(const Vector3& a, const Vector3& b)
+        : minPoint(std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z)),
+          maxPoint(std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z)) {}
+
+    // Caixa infinita (objetos ilimitados, ex: planos)
+    static AABB infinite() {
+        double inf = std::numeric_limits<double>::infinity();
+        AABB box;
+        box.minPoint = Vector3(-inf, -inf, -inf);
+        box.maxPoint = Vector3(inf, inf, inf);
+        return box;
+    }
+
+    void expand(const Vector3& p) {
+        minPoint = Vector3(std::min(minPoint.x, p.x), std::min(minPoint.y, p.y), std::min(minPoint.z, p.z));
+        maxPoint = Vector3(std::max(maxPoint.x, p.x), std::max(maxPoint.y, p.y), std::max(maxPoint.z, p.z));
+    }
+
+    void expand(const AABB& box) {
+        expand(box.minPoint);
+        expand(box.maxPoint);
+    }
+
+    bool isEmpty() const {
+        return minPoint.x > maxPoint.x || minPoint.y > maxPoint.y || minPoint.z > maxPoint.z;
+    }
+
+    bool isFinite() const {
+        return std::isfinite(minPoint.x) && std::isfinite(minPoint.y) && std::isfinite(minPoint.z) &&
+               std::isfinite(maxPoint.x) && std::isfinite(maxPoint.y) && std::isfinite(maxPoint.z);
+    }
+
+    Vector3 centroid() const {
+        return (minPoint + maxPoint) * 0.5;
+    }
+
+    Vector3 extent() const {
+        return maxPoint - minPoint;
+    }
+
+    double surfaceArea() const {
+        if (isEmpty()) return 0.0;
+        Vector3 e = extent();
+        return 2.0 * (e.x * e.y + e.y * e.z + e.z * e.x);
+    }
+
+    // Eixo de maior extensão (0 = x, 1 = y, 2 = z)
+    int longestAxis() const {
+        Vector3 e = extent();
+        if (e.x > e.y && e.x > e.z) return 0;
+        return (e.y > e.z) ? 1 : 2;
+    }
+
+    // Teste de slabs: retorna true se o raio cruza a caixa em [ray.tMin, tMax]
+    // tEntry recebe a distância de entrada (usada para ordenar a travessia).
+    // Usa o inverso e os sinais da direção guardados no raio: só multiplicações.
+    bool intersect(const Ray& ray, double tMax, double& tEntry) const {
+        double tMin = ray.tMin;
+        for (int axis = 0; axis < 3; axis++) {
+            const Vector3& nearPoint = ray.sign[axis] ? maxPoint : minPoint;
+            const Vector3& farPoint = ray.sign[axis] ? minPoint : maxPoint;
+            double t0 = (nearPoint[axis] - ray.origin[axis]) * ray.invDirection[axis];
+            double t1 = (farPoint[axis] - ray.origin[axis]) * ray.invDirection[axis];
+            tMin = t0 > tMin ? t0 : tMin;
+            tMax = t1 < tMax ? t1 : tMax;
+            if (tMax < tMin) return false;
+        }
+        tEntry = tMin;
+        return true;
+    }
+
+    // Mesmo teste para um pacote, cada raio com o seu tMax (tMax < 0 = raio
+    // inativo). Retorna true se algum raio cruza a caixa; tEntry recebe a
+    // menor distância de entrada entre eles.
+    bool intersect(const RayPacket& packet, const SimdReal* tMax, Real& tEntry) const {
+        const Real inf = std::numeric_limits<Real>::infinity();
+        SimdReal nearest = {};
+        nearest += inf;
+        for (int c = 0; c < PACKET_CHUNKS; c++) {
+            SimdReal tNear = {};
+            SimdReal tFar = tMax[c];
+            slab(minPoint.x, maxPoint.x, packet.ox[c], packet.invDx[c], tNear, tFar);
+            slab(minPoint.y, maxPoint.y, packet.oy[c], packet.invDy[c], tNear, tFar);
+            slab(minPoint.z, maxPoint.z, packet.oz[c], packet.invDz[c], tNear, tFar);
+            SimdReal entry = tFar < tNear ? inf : tNear;
+            nearest = entry < nearest ? entry : nearest;
+        }
+
+        Real minEntry = nearest[0];
+        for (int k = 1; k < SIMD_WIDTH; k++) {
+            minEntry = nearest[k] < minEntry ? nearest[k] : minEntry;
+        }
+        tEntry = minEntry;
+        return minEntry != inf;
+    }
+
+private:
+    static void slab(Real lo, Real hi, SimdReal origin, SimdReal invDir, SimdReal& tNear, SimdReal& tFar) {
+        SimdReal t0 = (lo - origin) * invDir;
+        SimdReal t1 = (hi - origin) * invDir;
+        SimdMask negative = invDir < 0;
+        SimdReal tIn = negative ? t1 : t0;
+        SimdReal tOut = negative ? t0 : t1;
+        tNear = tIn > tNear ? tIn : tNear;
+        tFar = tOut < tFar ? tOut : tFar;
+    }
+};
+
+#endif // AABB_H
@@ -0,0 +1,283 @@
+#ifndef BVH_H
+#define BVH_H
+
+#include "AABB.h"
+#include "Ray.h"
+#include "RayPacket.h"
+#include <vector>
+#include <cstdint>
+
+// Nó da BVH em layout plano (array contíguo)
+// - Nó interno: leftFirst = índice do filho esquerdo (o direito é leftFirst + 1), count = 0
+// - Folha:      leftFirst = primeiro índice em BVH::indices, count = número de primitivos
+struct BVHNode {
+    AABB bounds;
+    uint32_t leftFirst;
+    uint32_t count;
+
+    bool isLeaf() const { return count > 0; }
+};
+
+// HIERARQUIA DE VOLUMES ENVOLVENTES (Bounding Volume Hierarchy)
+// Genérica: é construída apenas a partir das caixas dos primitivos e
+// devolve índices, então serve tanto para objetos da cena quanto para
+// triângulos de uma malha.
+class BVH {
+public:
+    std::vector<BVHNode> nodes;
+    std::vector<uint32_t> indices;  // Permutação dos primitivos referenciada pelas folhas
+
+    // Constrói com SAH (Surface Area Heuristic) por bins. leafBatch é o
+    // número de primitivos que o chamador testa juntos numa folha (teste SIMD
+    // em lote): a folha custa ceil(count / leafBatch) testes no SAH.
+    void build(const std::vector<AABB>& primitiveBounds, int maxLeafSize = 4, int leafBatch = 1);
+    void clear();
+    bool empty() const { return nodes.empty(); }
+
+    // Profundidade máxima (raiz = 0) que a pilha fixa das travessias
+    // comporta: cada nível do caminho deixa no máximo um irmão pendente, e
+    // o último nó interno empilha os dois filhos
+    static const int MAX_DEPTH = 63;
+
+    // Travessia closest-hit.
+    // intersectPrimitive(índice, tMax) testa um primitivo; se houver acerto
+    // mais próximo que tMax, deve atualizar tMax e retornar true.
+    template <typename IntersectFn>
+    bool intersect(const Ray& ray, double& tMax, IntersectFn&& intersectPrimitive) const;
+
+    // Travessia any-hit: para no primeiro primitivo para o qual
+    // occludedPrimitive(índice, tMax) retornar true.
+    template <typename OccludedFn>
+    bool occluded(const Ray& ray, double tMax, OccludedFn&& occludedPrimitive) const;
+
+    // Travessia de um pacote de raios: um nó é visitado se algum raio do
+    // pacote o cruza antes do seu tMax. tMax (PACKET_CHUNKS registradores) é
+    // relido a cada nó: intersectPrimitive(índice) reduz o tMax dos raios
+    // que acertaram.
+    template <typename IntersectFn>
+    void intersect(const RayPacket& packet, const SimdReal* tMax, IntersectFn&& intersectPrimitive) const;
+
+    // Versão any-hit do pacote: termina quando occludedPrimitive(índice)
+    // retornar true (todos os raios bloqueados)
+    template <typename OccludedFn>
+    bool occluded(const RayPacket& packet, const SimdReal* tMax, OccludedFn&& occludedPrimitive) const;
+
+    // Variantes por folha das travessias acima: a função recebe a folha
+    // inteira, o intervalo [first, first + count) de indices, para que o
+    // chamador teste os seus primitivos de uma vez (ex: triângulos em lote
+    // SIMD guardados na ordem de indices). Mesmos retornos das versões por
+    // primitivo.
+    template <typename LeafFn>
+    bool intersectLeaves(const Ray& ray, double& tMax, LeafFn&& intersectLeaf) const;
+    template <typename LeafFn>
+    bool occludedLeaves(const Ray& ray, double tMax, LeafFn&& occludedLeaf) const;
+    template <typename LeafFn>
+    void intersectLeaves(const RayPacket& packet, const SimdReal* tMax, LeafFn&& intersectLeaf) const;
+    template <typename LeafFn>
+    bool occludedLeaves(const RayPacket& packet, const SimdReal* tMax, LeafFn&& occludedLeaf) const;
+
+private:
+    static const int STACK_SIZE = MAX_DEPTH + 1;
+
+    void subdivide(uint32_t nodeIndex, const std::vector<AABB>& primitiveBounds,
+                   const std::vector<Vector3>& centroids, int maxLeafSize, int leafBatch);
+    void updateBounds(uint32_t nodeIndex, const std::vector<AABB>& primitiveBounds);
+};
+
+template <typename LeafFn>
+bool BVH::intersectLeaves(const Ray& ray, double& tMax, LeafFn&& intersectLeaf) const {
+    if (nodes.empty()) return false;
+
+    bool hitAnything = false;
+    double tEntry;
+
+    if (!nodes[0].bounds.intersect(ray, tMax, tEntry)) return false;
+
+    uint32_t stack[STACK_SIZE];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const BVHNode& node = nodes[stack[--stackSize]];
+
+        if (node.isLeaf()) {
+            if (intersectLeaf(node.leftFirst, node.count, tMax)) {
+                hitAnything = true;
+            }
+            continue;
+        }
+
+        // Visita primeiro o filho mais próximo (empilhado por último)
+        uint32_t left = node.leftFirst;
+        uint32_t right = node.leftFirst + 1;
+        double tLeft, tRight;
+        bool hitLeft = nodes[left].bounds.intersect(ray, tMax, tLeft);
+        bool hitRight = nodes[right].bounds.intersect(ray, tMax, tRight);
+
+        if (hitLeft && hitRight) {
+            if (tLeft < tRight) {
+                stack[stackSize++] = right;
+                stack[stackSize++] = left;
+            } else {
+                stack[stackSize++] = left;
+                stack[stackSize++] = right;
+            }
+        } else if (hitLeft) {
+            stack[stackSize++] = left;
+        } else if (hitRight) {
+            stack[stackSize++] = right;
+        }
+    }
+
+    return hitAnything;
+}
+
+template <typename LeafFn>
+bool BVH::occludedLeaves(const Ray& ray, double tMax, LeafFn&& occludedLeaf) const {
+    if (nodes.empty()) return false;
+
+    double tEntry;
+
+    uint32_t stack[STACK_SIZE];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const BVHNode& node = nodes[stack[--stackSize]];
+
+        if (!node.bounds.intersect(ray, tMax, tEntry)) continue;
+
+        if (node.isLeaf()) {
+            if (occludedLeaf(node.leftFirst, node.count, tMax)) {
+                return true;
+            }
+            continue;
+        }
+
+        stack[stackSize++] = node.leftFirst;
+        stack[stackSize++] = node.leftFirst + 1;
+    }
+
+    return false;
+}
+
+template <typename LeafFn>
+void BVH::intersectLeaves(const RayPacket& packet, const SimdReal* tMax, LeafFn&& intersectLeaf) const {
+    if (nodes.empty()) return;
+
+    Real tEntry;
+    if (!nodes[0].bounds.intersect(packet, tMax, tEntry)) return;
+
+    uint32_t stack[STACK_SIZE];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const BVHNode& node = nodes[stack[--stackSize]];
+
+        if (node.isLeaf()) {
+            intersectLeaf(node.leftFirst, node.count);
+            continue;
+        }
+
+        // Filho com a menor entrada entre os raios do pacote vai por último
+        uint32_t left = node.leftFirst;
+        uint32_t right = node.leftFirst + 1;
+        Real tLeft, tRight;
+        bool hitLeft = nodes[left].bounds.intersect(packet, tMax, tLeft);
+        bool hitRight = nodes[right].bounds.intersect(packet, tMax, tRight);
+
+        if (hitLeft && hitRight) {
+            if (tLeft < tRight) {
+                stack[stackSize++] = right;
+                stack[stackSize++] = left;
+            } else {
+                stack[stackSize++] = left;
+                stack[stackSize++] = right;
+            }
+        } else if (hitLeft) {
+            stack[stackSize++] = left;
+        } else if (hitRight) {
+            stack[stackSize++] = right;
+        }
+    }
+}
+
+template <typename LeafFn>
+bool BVH::occludedLeaves(const RayPacket& packet, const SimdReal* tMax, LeafFn&& occludedLeaf) const {
+    if (nodes.empty()) return false;
+
+    Real tEntry;
+
+    uint32_t stack[STACK_SIZE];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const BVHNode& node = nodes[stack[--stackSize]];
+
+        if (!node.bounds.intersect(packet, tMax, tEntry)) continue;
+
+        if (node.isLeaf()) {
+            if (occludedLeaf(node.leftFirst, node.count)) {
+                return true;
+            }
+            continue;
+        }
+
+        stack[stackSize++] = node.leftFirst;
+        stack[stackSize++] = node.leftFirst + 1;
+    }
+
+    return false;
+}
+
+// Versões por primitivo: percorrem a folha primitivo a primitivo
+
+template <typename IntersectFn>
+bool BVH::intersect(const Ray& ray, double& tMax, IntersectFn&& intersectPrimitive) const {
+    return intersectLeaves(ray, tMax, [&](uint32_t first, uint32_t count, double& tMax) {
+        bool hitAnything = false;
+        for (uint32_t i = 0; i < count; i++) {
+            if (intersectPrimitive(indices[first + i], tMax)) {
+                hitAnything = true;
+            }
+        }
+        return hitAnything;
+    });
+}
+
+template <typename OccludedFn>
+bool BVH::occluded(const Ray& ray, double tMax, OccludedFn&& occludedPrimitive) const {
+    return occludedLeaves(ray, tMax, [&](uint32_t first, uint32_t count, double tMax) {
+        for (uint32_t i = 0; i < count; i++) {
+            if (occludedPrimitive(indices[first + i], tMax)) {
+                return true;
+            }
+        }
+        return false;
+    });
+}
+
+template <typename IntersectFn>
+void BVH::intersect(const RayPacket& packet, const SimdReal* tMax, IntersectFn&& intersectPrimitive) const {
+    intersectLeaves(packet, tMax, [&](uint32_t first, uint32_t count) {
+        for (uint32_t i = 0; i < count; i++) {
+            intersectPrimitive(indices[first + i]);
+        }
+    });
+}
+
+template <typename OccludedFn>
+bool BVH::occluded(const RayPacket& packet, const SimdReal* tMax, OccludedFn&& occludedPrimitive) const {
+    return occludedLeaves(packet, tMax, [&](uint32_t first, uint32_t count) {
+        for (uint32_t i = 0; i < count; i++) {
+            if (occludedPrimitive(indices[first + i])) {
+                return true;
+            }
+        }
+        return false;
+    });
+}
+
+#endif // BVH_H
@@ -3,6 +3,7 @@
 
 #include "Vector3.h"
 #include "Ray.h"
+#include <vector>
 
 // Tipos de projeção suportados
 enum class ProjectionType {
@@ -49,4 +50,50 @@ public:
     void setObliqueCabinet();  // Atalho para projeção cabinet (angle=63.4°, factor=0.5)
 };
 
+// GERADOR DE RAIOS PRIMÁRIOS
+// Construído uma vez por quadro a partir do estado da câmera: a base, o ponto
+// de partida do plano de projeção e os termos u * x (por coluna) e v * y
+// (por linha) ficam em tabelas, e cada raio custa duas somas (mais a
+// normalização na perspectiva). Os termos são calculados com as mesmas
+// fórmulas e na mesma ordem de Camera::getRay, então os raios são idênticos.
+// Deve ser reconstruído se a câmera mudar (posição, janela, projeção, resolução).
+class CameraRayGenerator {
+public:
+    explicit CameraRayGenerator(const Camera& camera);
+
+    Ray getRay(int i, int j) const {
+        if (projectionType == ProjectionType::PERSPECTIVE) {
+            Vector3 pointOnPlane = planeStart + columnTerms[i] + rowTerms[j];
+            return Ray(eye, (pointOnPlane - eye).normalized(), RayDirection::UNIT);
+        }
+        // Ortográfica e oblíqua: direção fixa, origem varia no plano da câmera
+        return Ray(eye + columnTerms[i] + rowTerms[j], parallelDirection, RayDirection::UNIT);
+    }
+
+    // Diferenciais do raio (i, j) por pixel: na perspectiva só a direção
+    // varia, nas projeções paralelas só a origem
+    RayDifferential getDifferential(int i, int j) const {
+        RayDifferential diff;
+        if (projectionType == ProjectionType::PERSPECTIVE) {
+            Vector3 toPlane = planeStart + columnTerms[i] + rowTerms[j] - eye;
+            diff.dDdx = RayDifferential::normalizedDerivative(toPlane, columnStep);
+            diff.dDdy = RayDifferential::normalizedDerivative(toPlane, rowStep);
+        } else {
+            diff.dOdx = columnStep;
+            diff.dOdy = rowStep;
+        }
+        return diff;
+    }
+
+private:
+    ProjectionType projectionType;
+    Vector3 eye;
+    Vector3 planeStart;          // eye - w * d (perspectiva)
+    Vector3 parallelDirection;   // -w (ortográfica) ou direção oblíqua
+    std::vector<Vector3> columnTerms;  // u * x de cada coluna
+    std::vector<Vector3> rowTerms;     // v * y de cada linha
+    Vector3 columnStep;          // Deslocamento no plano de projeção por coluna
+    Vector3 rowStep;             // e por linha (y invertido)
+};
+
 #endif // CAMERA_H
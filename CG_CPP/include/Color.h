@@ -1,33 +1,43 @@
 #ifndef COLOR_H
 #define COLOR_H
 
+#include "Real.h"
 #include <algorithm>
 #include <iostream>
 
-class Color {
+// Cor RGB genérica na precisão T (float ou double).
+// O restante do código usa o alias Color = ColorT<Real>.
+template <typename T>
+class ColorT {
 public:
-    double r, g, b;
+    typedef T value_type;
+    T r, g, b;
 
-    Color() : r(0), g(0), b(0) {}
-    Color(double r, double g, double b) : r(r), g(g), b(b) {}
+    ColorT() : r(0), g(0), b(0) {}
+    ColorT(T r, T g, T b) : r(r), g(g), b(b) {}
 
-    Color operator+(const Color& c) const {
-        return Color(r + c.r, g + c.g, b + c.b);
+    // Conversão explícita entre precisões
+    template <typename U>
+    explicit ColorT(const ColorT<U>& c)
+        : r(static_cast<T>(c.r)), g(static_cast<T>(c.g)), b(static_cast<T>(c.b)) {}
+
+    ColorT operator+(const ColorT& c) const {
+        return ColorT(r + c.r, g + c.g, b + c.b);
     }
 
-    Color operator*(const Color& c) const {
-        return Color(r * c.r, g * c.g, b * c.b);
+    ColorT operator*(const ColorT& c) const {
+        return ColorT(r * c.r, g * c.g, b * c.b);
     }
 
-    Color operator*(double t) const {
-        return Color(r * t, g * t, b * t);
+    ColorT operator*(T t) const {
+        return ColorT(r * t, g * t, b * t);
     }
 
-    Color operator/(double t) const {
-        return Color(r / t, g / t, b / t);
+    ColorT operator/(T t) const {
+        return ColorT(r / t, g / t, b / t);
     }
 
-    void clamp(double minVal = 0.0, double maxVal = 1.0) {
+    void clamp(T minVal = 0, T maxVal = 1) {
         r = std::max(minVal, std::min(maxVal, r));
         g = std::max(minVal, std::min(maxVal, g));
         b = std::max(minVal, std::min(maxVal, b));
@@ -39,10 +49,18 @@ public:
         ig = static_cast<int>(std::max(0.0, std::min(255.0, g * 255.0)));
         ib = static_cast<int>(std::max(0.0, std::min(255.0, b * 255.0)));
     }
+
+    friend ColorT operator*(T t, const ColorT& c) {
+        return c * t;
+    }
 };
 
-inline Color operator*(double t, const Color& c) {
-    return c * t;
+typedef ColorT<Real> Color;
+
+// Multiplicação-acumulação usada nos laços de iluminação: a * s + c
+template <typename T>
+inline ColorT<T> madd(const ColorT<T>& a, typename ColorT<T>::value_type s, const ColorT<T>& c) {
+    return a * s + c;
 }
 
 // Cores pré-definidas
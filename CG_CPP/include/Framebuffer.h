@@ -0,0 +1,76 @@
+#ifndef FRAMEBUFFER_H
+#define FRAMEBUFFER_H
+
+#include "Color.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Formatos de armazenamento do framebuffer
+enum class PixelFormat {
+    RGB32F,   // 3 x float (12 bytes/pixel) - metade da memória de Color (double)
+    RGBA16F,  // 4 x half  (8 bytes/pixel)
+    RGBA8     // 4 x uint8 (4 bytes/pixel) - pronto para upload em textura OpenGL
+};
+
+// Bytes ocupados por um pixel no formato dado
+int pixelFormatSize(PixelFormat format);
+
+// Conversão float <-> half (IEEE 754 binário de 16 bits)
+uint16_t floatToHalf(float value);
+float halfToFloat(uint16_t value);
+
+// FRAMEBUFFER CONTÍGUO
+// Um único bloco de memória, linha a linha. Cada linha começa num
+// múltiplo de 64 bytes (uma linha de cache), então tiles de threads
+// diferentes nunca compartilham a mesma linha de cache entre linhas
+// da imagem. Tiles de 16 pixels também ocupam múltiplos de 64 bytes
+// dentro da linha nos três formatos.
+class Framebuffer {
+public:
+    static const int ROW_ALIGNMENT = 64;
+
+    Framebuffer();
+    Framebuffer(int width, int height, PixelFormat format = PixelFormat::RGB32F);
+
+    void resize(int width, int height, PixelFormat format);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    PixelFormat getFormat() const { return format; }
+    bool empty() const { return width == 0 || height == 0; }
+
+    // Distância em bytes entre o início de duas linhas consecutivas
+    size_t rowStride() const { return stride; }
+    size_t sizeInBytes() const { return stride * height; }
+
+    uint8_t* data() { return reinterpret_cast<uint8_t*>(storage.data()); }
+    const uint8_t* data() const { return reinterpret_cast<const uint8_t*>(storage.data()); }
+    uint8_t* row(int y) { return data() + stride * y; }
+    const uint8_t* row(int y) const { return data() + stride * y; }
+
+    // Acesso por pixel (converte de/para o formato armazenado).
+    // RGBA8 usa a mesma quantização 255.99 * c do writer PPM.
+    void setPixel(int x, int y, const Color& color);
+    Color getPixel(int x, int y) const;
+
+    // Acesso por trecho de linha: usado por tiles e pelo writer de imagem
+    void writeSpan(int x, int y, const Color* pixels, int count);
+    void readSpan(int x, int y, Color* pixels, int count) const;
+
+    void clear(const Color& color = Color());
+
+private:
+    // Bloco alinhado a uma linha de cache (std::vector respeita alignas em C++17)
+    struct alignas(ROW_ALIGNMENT) CacheLine {
+        uint8_t bytes[ROW_ALIGNMENT];
+    };
+
+    std::vector<CacheLine> storage;
+    int width;
+    int height;
+    size_t stride;
+    PixelFormat format;
+};
+
+#endif // FRAMEBUFFER_H
@@ -0,0 +1,64 @@
+#ifndef IMAGEIO_H
+#define IMAGEIO_H
+
+#include "Color.h"
+#include "Framebuffer.h"
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Formatos PPM suportados
+enum class PPMFormat {
+    ASCII_P3,      // Texto (legível, grande e lento)
+    BINARY_P6,     // Binário 8 bits por canal
+    BINARY_P6_16   // Binário 16 bits por canal (big-endian, maxval 65535)
+};
+
+// Bytes por pixel no corpo do arquivo (0 para P3, que não tem tamanho fixo)
+int ppmBytesPerPixel(PPMFormat format);
+
+// Converte 'count' pixels para o formato binário em 'out' (um único passo)
+void encodePPMPixels(const Color* pixels, int count, PPMFormat format, uint8_t* out);
+
+// Salva uma imagem contígua (linha a linha, width * height pixels).
+// Nos formatos binários o corpo é convertido num buffer e gravado com um único write.
+bool writePPM(const std::string& filename, const Color* pixels, int width, int height,
+              PPMFormat format = PPMFormat::BINARY_P6);
+
+// Salva um Framebuffer em qualquer formato de armazenamento
+bool writePPM(const std::string& filename, const Framebuffer& framebuffer,
+              PPMFormat format = PPMFormat::BINARY_P6);
+
+// ESCRITA INCREMENTAL DE PPM BINÁRIO
+// O cabeçalho é gravado na abertura e cada trecho de linha pode ser gravado
+// assim que termina de renderizar, em qualquer ordem (o deslocamento no
+// arquivo é calculado a partir de x, y). Seguro para várias threads.
+class PPMStreamWriter {
+public:
+    PPMStreamWriter();
+    ~PPMStreamWriter();
+
+    // Apenas formatos binários (P3 não tem deslocamento fixo por pixel)
+    bool open(const std::string& filename, int width, int height,
+              PPMFormat format = PPMFormat::BINARY_P6);
+    bool isOpen() const { return file.is_open(); }
+
+    // Grava 'count' pixels da linha y a partir da coluna x
+    void writeSpan(int x, int y, const Color* pixels, int count);
+    bool close();
+
+    PPMStreamWriter(const PPMStreamWriter&) = delete;
+    PPMStreamWriter& operator=(const PPMStreamWriter&) = delete;
+
+private:
+    std::ofstream file;
+    std::mutex mutex;
+    std::streamoff headerSize;
+    int width;
+    int height;
+    PPMFormat format;
+};
+
+#endif // IMAGEIO_H
@@ -0,0 +1,39 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// ARQUIVO MAPEADO EM MEMÓRIA (somente leitura)
+// O conteúdo é lido sob demanda pelo sistema operacional, sem cópia para um
+// buffer do processo: os parsers percorrem data() direto, e várias threads
+// podem ler partes diferentes ao mesmo tempo. O mapeamento vale até close()
+// ou a destruição do objeto.
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    bool open(const std::string& filename);
+    void close();
+    bool isOpen() const { return opened; }
+
+    // Arquivo vazio: aberto, com size() == 0 e data() == nullptr
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+private:
+    const char* bytes;
+    size_t length;
+    bool opened;
+};
+
+// Identidade de um arquivo de origem para os caches binários: tamanho e
+// data de modificação (ns). Falso se o arquivo não existe.
+bool fileStamp(const std::string& filename, uint64_t& size, int64_t& time);
+
+#endif // MAPPEDFILE_H
@@ -4,6 +4,7 @@
 #include "Vector3.h"
 #include <cmath>
 #include <array>
+#include <utility>
 
 class Matrix4x4 {
 public:
@@ -59,6 +60,52 @@ public:
         return Vector3(x, y, z);
     }
 
+    // Transposta
+    Matrix4x4 transposed() const {
+        Matrix4x4 result;
+        for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < 4; j++) {
+                result.m[i][j] = m[j][i];
+            }
+        }
+        return result;
+    }
+
+    // Inversa por eliminação de Gauss-Jordan com pivoteamento parcial
+    // (retorna a identidade se a matriz for singular)
+    Matrix4x4 inverse() const {
+        std::array<std::array<double, 4>, 4> a = m;
+        Matrix4x4 result;
+
+        for (int col = 0; col < 4; col++) {
+            int pivot = col;
+            for (int row = col + 1; row < 4; row++) {
+                if (std::fabs(a[row][col]) > std::fabs(a[pivot][col])) pivot = row;
+            }
+            if (std::fabs(a[pivot][col]) < 1e-12) return Matrix4x4();
+
+            std::swap(a[col], a[pivot]);
+            std::swap(result.m[col], result.m[pivot]);
+
+            double invPivot = 1.0 / a[col][col];
+            for (int j = 0; j < 4; j++) {
+                a[col][j] *= invPivot;
+                result.m[col][j] *= invPivot;
+            }
+
+            for (int row = 0; row < 4; row++) {
+                if (row == col || a[row][col] == 0.0) continue;
+                double factor = a[row][col];
+                for (int j = 0; j < 4; j++) {
+                    a[row][j] -= factor * a[col][j];
+                    result.m[row][j] -= factor * result.m[col][j];
+                }
+            }
+        }
+
+        return result;
+    }
+
     // ============ TRANSFORMAÇÕES BÁSICAS ============
 
     // Matriz identidade
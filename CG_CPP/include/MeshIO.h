@@ -0,0 +1,43 @@
+#ifndef MESHIO_H
+#define MESHIO_H
+
+#include "Objects.h"
+#include "ThreadPool.h"
+#include <memory>
+#include <string>
+
+// IMPORTAÇÃO DE WAVEFRONT OBJ
+// Lê posições (v), normais (vn), coordenadas de textura (vt) e faces (f,
+// polígonos triangulados em leque; índices negativos são relativos). O
+// arquivo é mapeado em memória e dividido em blocos de linhas processados
+// em paralelo no pool, sem std::string por linha: uma passada conta os
+// elementos de cada bloco e a segunda escreve direto nos buffers da malha.
+// Vértices com a mesma posição mas normal/UV diferentes são duplicados
+// (a malha tem um índice só por vértice). Outras linhas (o, g, s, usemtl,
+// mtllib) são ignoradas: a malha inteira usa 'material'.
+// Retorna a malha com a BVH construída, ou nullptr em caso de erro.
+// Sem pool, usa um temporário com uma thread por núcleo.
+std::shared_ptr<Mesh> loadOBJ(const std::string& filename, const Material& material,
+                              ThreadPool* pool = nullptr);
+
+// CACHE BINÁRIO DE MALHA
+// Buffers de vértices/índices, tabela de materiais e a BVH (nós e
+// permutação) gravados exatamente como ficam na memória, cada seção
+// alinhada a 64 bytes. A leitura mapeia o arquivo e copia cada seção em
+// bloco para a malha, sem parsing e sem reconstruir a BVH (só as arestas
+// pré-calculadas, uma passada linear). O cabeçalho guarda versão, tamanho
+// de Real e de BVHNode: um cache de outra versão ou compilado em outra
+// precisão é recusado. Funções de textura (ponteiros) não são salvas.
+const uint32_t MESH_CACHE_VERSION = 1;
+
+bool saveMeshCache(const std::string& filename, const Mesh& mesh);
+std::shared_ptr<Mesh> loadMeshCache(const std::string& filename);
+
+// loadOBJ com cache em cacheFilename (padrão: objFilename + ".cache"): usa o
+// cache se ele foi gerado a partir do OBJ atual (tamanho e data de
+// modificação iguais); senão importa o OBJ e regrava o cache. Nos dois
+// casos a malha usa 'material'.
+std::shared_ptr<Mesh> loadOBJCached(const std::string& objFilename, const Material& material,
+                                    ThreadPool* pool = nullptr, const std::string& cacheFilename = "");
+
+#endif // MESHIO_H
@@ -3,23 +3,77 @@
 
 #include "Vector3.h"
 #include "Ray.h"
+#include "RayPacket.h"
 #include "Material.h"
+#include "AABB.h"
+#include "BVH.h"
 #include <vector>
 #include <memory>
 #include <limits>
+#include <cstdint>
 #include <string>
 
 // Forward declaration
 class Object;
 
+// Registro de interseção compacto (32 bytes): é o que o laço closest-hit
+// copia a cada acerto mais próximo. Preenchido por Object::intersect.
 struct HitRecord {
     double t;
+    const Object* object;  // Ponteiro para objeto atingido (para picking)
+    uint32_t primId;       // Primitivo dentro do objeto (ex: triângulo da malha)
+    float u, v;            // Parâmetros locais (ex: baricêntricas do triângulo)
+
+    HitRecord() : t(std::numeric_limits<double>::max()), object(nullptr), primId(0), u(0), v(0) {}
+};
+
+// Acertos de um pacote de raios: um HitRecord por raio, em SoA.
+// O t do raio k começa como o seu limite e só diminui; raios com t < 0
+// estão inativos (nenhum intersector aceita acerto antes de EPSILON).
+struct PacketHit {
+    SimdReal t[PACKET_CHUNKS];
+    const Object* object[PACKET_SIZE];
+    uint32_t primId[PACKET_SIZE];
+    float u[PACKET_SIZE];
+    float v[PACKET_SIZE];
+
+    PacketHit() {
+        for (int k = 0; k < PACKET_SIZE; k++) {
+            setPacketLane(t, k, std::numeric_limits<Real>::infinity());
+            object[k] = nullptr;
+            primId[k] = 0;
+            u[k] = v[k] = 0;
+        }
+    }
+
+    void set(int lane, const HitRecord& rec) {
+        setPacketLane(t, lane, rec.t);
+        object[lane] = rec.object;
+        primId[lane] = rec.primId;
+        u[lane] = rec.u;
+        v[lane] = rec.v;
+    }
+
+    HitRecord record(int lane) const {
+        HitRecord rec;
+        rec.t = packetLane(t, lane);
+        rec.object = object[lane];
+        rec.primId = primId[lane];
+        rec.u = u[lane];
+        rec.v = v[lane];
+        return rec;
+    }
+};
+
+// Dados de superfície para sombreamento: montados uma única vez, para o
+// acerto final, por Object::computeSurface
+struct SurfaceRecord {
     Vector3 point;
     Vector3 normal;
-    Material material;
-    const Object* object;  // Ponteiro para objeto atingido (para picking)
+    const Material* material;  // Referência ao material do objeto (sem cópia)
+    float texU, texV;          // Coordenadas de textura (malhas com UVs)
 
-    HitRecord() : t(std::numeric_limits<double>::max()), object(nullptr) {}
+    SurfaceRecord() : material(nullptr), texU(0), texV(0) {}
 };
 
 class Object {
@@ -32,8 +86,29 @@ public:
     Object(const Material& mat, const std::string& objName) : material(mat), name(objName) {}
     virtual ~Object() {}
 
-    virtual bool intersect(const Ray& ray, HitRecord& rec) const = 0;
+    // Teste barato: se houver acerto em (EPSILON, tMax), preenche apenas
+    // rec.t, rec.object, rec.primId e rec.u/v e retorna true
+    virtual bool intersect(const Ray& ray, double tMax, HitRecord& rec) const = 0;
+
+    // Versão para pacotes: para cada raio k que acerta o objeto antes do t
+    // atual do raio em hit, atualiza o acerto k. A padrão testa raio a raio.
+    virtual void intersect(const RayPacket& packet, PacketHit& hit) const;
+
+    // Monta ponto, normal e material de um acerto retornado por intersect
+    virtual void computeSurface(const Ray& ray, const HitRecord& rec, SurfaceRecord& surface) const = 0;
+
+    // Consulta any-hit (sombras): existe acerto em (EPSILON, tMax)?
+    // Não precisa do mais próximo, então pode parar no primeiro encontrado.
+    virtual bool occluded(const Ray& ray, double tMax) const {
+        HitRecord rec;
+        return intersect(ray, tMax, rec);
+    }
+
+    virtual AABB boundingBox() const = 0;     // Caixa envolvente em coordenadas de mundo
     virtual std::string getType() const = 0;  // Retorna tipo do objeto
+
+    // Pré-processamento antes de renderizar (ex: BVH interna de uma malha)
+    virtual void prepare() {}
 };
 
 // ESFERA
@@ -48,7 +123,10 @@ public:
     Sphere(const Vector3& center, double radius, const Material& mat, const std::string& name)
         : Object(mat, name), center(center), radius(radius) {}
 
-    bool intersect(const Ray& ray, HitRecord& rec) const override;
+    bool intersect(const Ray& ray, double tMax, HitRecord& rec) const override;
+    void intersect(const RayPacket& packet, PacketHit& hit) const override;
+    void computeSurface(const Ray& ray, const HitRecord& rec, SurfaceRecord& surface) const override;
+    AABB boundingBox() const override;
     std::string getType() const override { return "Sphere"; }
 };
 
@@ -64,7 +142,10 @@ public:
     Plane(const Vector3& point, const Vector3& normal, const Material& mat, const std::string& name)
         : Object(mat, name), point(point), normal(normal.normalized()) {}
 
-    bool intersect(const Ray& ray, HitRecord& rec) const override;
+    bool intersect(const Ray& ray, double tMax, HitRecord& rec) const override;
+    void intersect(const RayPacket& packet, PacketHit& hit) const override;
+    void computeSurface(const Ray& ray, const HitRecord& rec, SurfaceRecord& surface) const override;
+    AABB boundingBox() const override;
     std::string getType() const override { return "Plane"; }
 };
 
@@ -82,7 +163,10 @@ public:
     Cylinder(const Vector3& base, double r, double h, const Vector3& axis, const Material& mat, const std::string& name)
         : Object(mat, name), baseCenter(base), radius(r), height(h), axis(axis.normalized()) {}
 
-    bool intersect(const Ray& ray, HitRecord& rec) const override;
+    bool intersect(const Ray& ray, double tMax, HitRecord& rec) const override;
+    void intersect(const RayPacket& packet, PacketHit& hit) const override;
+    void computeSurface(const Ray& ray, const HitRecord& rec, SurfaceRecord& surface) const override;
+    AABB boundingBox() const override;
     std::string getType() const override { return "Cylinder"; }
 };
 
@@ -100,7 +184,10 @@ public:
     Cone(const Vector3& base, double r, double h, const Vector3& axis, const Material& mat, const std::string& name)
         : Object(mat, name), baseCenter(base), radius(r), height(h), axis(axis.normalized()) {}
 
-    bool intersect(const Ray& ray, HitRecord& rec) const override;
+    bool intersect(const Ray& ray, double tMax, HitRecord& rec) const override;
+    void intersect(const RayPacket& packet, PacketHit& hit) const override;
+    void computeSurface(const Ray& ray, const HitRecord& rec, SurfaceRecord& surface) const override;
+    AABB boundingBox() const override;
     std::string getType() const override { return "Cone"; }
 };
 
@@ -108,40 +195,117 @@ public:
 class Triangle : public Object {
 public:
     Vector3 v0, v1, v2;
+    Vector3 edge1, edge2;  // v1 - v0 e v2 - v0, usadas por Möller-Trumbore a cada raio
     Vector3 normal;
     
-    Triangle() : v0(0,0,0), v1(1,0,0), v2(0,1,0) {
-        Vector3 edge1 = v1 - v0;
-        Vector3 edge2 = v2 - v0;
+    Triangle() : v0(0,0,0), v1(1,0,0), v2(0,1,0), edge1(v1 - v0), edge2(v2 - v0) {
         normal = edge1.cross(edge2).normalized();
     }
     
     Triangle(const Vector3& v0, const Vector3& v1, const Vector3& v2, const Material& mat)
-        : Object(mat), v0(v0), v1(v1), v2(v2) {
-        Vector3 edge1 = v1 - v0;
-        Vector3 edge2 = v2 - v0;
+        : Object(mat), v0(v0), v1(v1), v2(v2), edge1(v1 - v0), edge2(v2 - v0) {
         normal = edge1.cross(edge2).normalized();
     }
 
-    bool intersect(const Ray& ray, HitRecord& rec) const override;
+    bool intersect(const Ray& ray, double tMax, HitRecord& rec) const override;
+    void intersect(const RayPacket& packet, PacketHit& hit) const override;
+    void computeSurface(const Ray& ray, const HitRecord& rec, SurfaceRecord& surface) const override;
+    AABB boundingBox() const override;
     std::string getType() const override { return "Triangle"; }
 };
 
-// MALHA
+// TRIÂNGULOS PRÉ-PROCESSADOS (SoA)
+// v0, edge1 e edge2 de cada triângulo, componente a componente, na ordem
+// das folhas da BVH da malha: os triângulos de uma folha são contíguos e um
+// raio é testado contra SIMD_WIDTH deles por instrução. Os arrays têm
+// SIMD_WIDTH - 1 posições extras (degeneradas) para a leitura do último bloco.
+struct TriangleBatch {
+    std::vector<Real> v0x, v0y, v0z;
+    std::vector<Real> e1x, e1y, e1z;
+    std::vector<Real> e2x, e2y, e2z;
+
+    void clear();
+    void resize(size_t count);
+    void set(size_t slot, const Vector3& v0, const Vector3& v1, const Vector3& v2);
+    size_t size() const { return v0x.size(); }
+
+    // Acerto mais próximo do raio entre os triângulos [first, first + count)
+    // antes de tMax: retorna a posição (ou -1) e preenche rec.t e rec.u/v
+    int intersect(const Ray& ray, uint32_t first, uint32_t count, double tMax, HitRecord& rec) const;
+    // Algum triângulo de [first, first + count) bloqueia o raio antes de tMax?
+    bool occluded(const Ray& ray, uint32_t first, uint32_t count, double tMax) const;
+};
+
+// MALHA INDEXADA
+// Vértices compartilhados em buffers float (x, y, z contíguos) e três
+// índices uint32 por triângulo, lidos direto pelos testes de interseção.
+// Normais e UVs por vértice são opcionais (vazios = normal da face, UV 0).
+// O material é o da malha ou, se definido, um por face (faceMaterials).
+// buildBVH monta também as arestas pré-calculadas (TriangleBatch).
 class Mesh : public Object {
 public:
-    std::vector<Triangle> triangles;
-    
-    Mesh() {}
-    Mesh(const Material& mat) : Object(mat) {}
-    Mesh(const Material& mat, const std::string& name) : Object(mat, name) {}
+    std::vector<float> positions;       // 3 floats por vértice
+    std::vector<float> normals;         // Opcional: 3 floats por vértice
+    std::vector<float> texcoords;       // Opcional: 2 floats por vértice
+    std::vector<uint32_t> indices;      // 3 índices por triângulo
+    std::vector<Material> materials;    // Materiais adicionais (addMaterial)
+    std::vector<uint32_t> faceMaterials;  // Por triângulo: 0 = material da malha, k = materials[k - 1]
+
+    Mesh() : bvhDirty(true) {}
+    Mesh(const Material& mat) : Object(mat), bvhDirty(true) {}
+    Mesh(const Material& mat, const std::string& name) : Object(mat, name), bvhDirty(true) {}
+
+    // Retornam o índice do vértice adicionado. Misturar as duas formas
+    // deixa normais/UVs com tamanho diferente das posições (ignorados).
+    uint32_t addVertex(const Vector3& p);
+    uint32_t addVertex(const Vector3& p, const Vector3& n, float u, float v);
 
-    void addTriangle(const Triangle& tri) {
-        triangles.push_back(tri);
+    // Retorna o id de material a usar em addTriangle
+    uint32_t addMaterial(const Material& mat);
+
+    void addTriangle(uint32_t i0, uint32_t i1, uint32_t i2, uint32_t materialId = 0);
+    // Triângulo solto: três vértices novos, sem compartilhamento
+    void addTriangle(const Vector3& p0, const Vector3& p1, const Vector3& p2);
+
+    uint32_t vertexCount() const { return static_cast<uint32_t>(positions.size() / 3); }
+    uint32_t triangleCount() const { return static_cast<uint32_t>(indices.size() / 3); }
+
+    Vector3 vertex(uint32_t i) const {
+        return Vector3(positions[3 * i], positions[3 * i + 1], positions[3 * i + 2]);
+    }
+
+    const Material& faceMaterial(uint32_t primId) const {
+        uint32_t id = faceMaterials.empty() ? 0 : faceMaterials[primId];
+        return id == 0 ? material : materials[id - 1];
     }
 
-    bool intersect(const Ray& ray, HitRecord& rec) const override;
+    // Constrói a BVH dos triângulos. Chamar depois do último addTriangle;
+    // sem ela, intersect testa todos os triângulos.
+    void buildBVH();
+    void prepare() override { if (bvhDirty) buildBVH(); }
+
+    // BVH já construída para estes triângulos (ex: lida de um cache): só
+    // monta o TriangleBatch, sem refazer o SAH
+    void setBVH(BVH&& prebuilt);
+    const BVH& getBVH() const { return bvh; }
+    bool hasBVH() const { return !bvhDirty; }
+
+    bool intersect(const Ray& ray, double tMax, HitRecord& rec) const override;
+    void intersect(const RayPacket& packet, PacketHit& hit) const override;
+    void computeSurface(const Ray& ray, const HitRecord& rec, SurfaceRecord& surface) const override;
+    bool occluded(const Ray& ray, double tMax) const override;
+    AABB boundingBox() const override;
     std::string getType() const override { return "Mesh"; }
+
+private:
+    BVH bvh;
+    TriangleBatch batch;  // Triângulos na ordem de bvh.indices
+    bool bvhDirty;
+
+    bool intersectTriangle(uint32_t primId, const Ray& ray, double tMax, HitRecord& rec) const;
+    void intersectTriangle(uint32_t primId, const RayPacket& packet, PacketHit& hit) const;
+    AABB triangleBounds(uint32_t primId) const;
+    void buildBatch();
 };
 
 #endif // OBJECTS_H
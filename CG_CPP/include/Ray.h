@@ -2,19 +2,76 @@
 #define RAY_H
 
 #include "Vector3.h"
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+// Como o construtor trata a direção recebida
+enum class RayDirection {
+    NORMALIZE,  // Normaliza (padrão)
+    UNIT        // Usada como está: já unitária, ou não unitária de propósito (ex: raio em espaço local)
+};
 
 class Ray {
 public:
     Vector3 origin;
     Vector3 direction;
+    Vector3 invDirection;  // 1 / direção por eixo: o teste de slabs multiplica em vez de dividir
+    uint8_t sign[3];       // 1 se a direção é negativa no eixo (qual face da caixa é a de entrada)
+    double tMin;           // Intervalo válido do raio
+    double tMax;
 
-    Ray() {}
-    Ray(const Vector3& origin, const Vector3& direction)
-        : origin(origin), direction(direction.normalized()) {}
+    Ray() : sign{0, 0, 0}, tMin(0), tMax(std::numeric_limits<double>::max()) {}
+
+    Ray(const Vector3& origin, const Vector3& direction, RayDirection mode = RayDirection::NORMALIZE)
+        : origin(origin),
+          direction(mode == RayDirection::NORMALIZE ? direction.normalized() : direction),
+          tMin(0), tMax(std::numeric_limits<double>::max()) {
+        invDirection = Vector3(1.0 / this->direction.x, 1.0 / this->direction.y, 1.0 / this->direction.z);
+        sign[0] = invDirection.x < 0;
+        sign[1] = invDirection.y < 0;
+        sign[2] = invDirection.z < 0;
+    }
 
     Vector3 at(double t) const {
         return origin + direction * t;
     }
 };
 
+// DIFERENCIAIS DE RAIO (Igehy)
+// Quanto a origem e a direção do raio mudam ao passar para o pixel vizinho
+// em x e em y. Transferidas até o ponto de acerto, dão o "pé" do pixel na
+// superfície (dP/dx, dP/dy), de onde sai a área de textura coberta pelo
+// pixel e o nível de mip a amostrar. Ficam fora de Ray para não aumentar os
+// raios de sombra e de picking, que não precisam delas.
+struct RayDifferential {
+    Vector3 dOdx, dOdy;  // Variação da origem
+    Vector3 dDdx, dDdy;  // Variação da direção (unitária)
+
+    // Derivada de v / |v| quando v varia dv (direção normalizada da câmera)
+    static Vector3 normalizedDerivative(const Vector3& v, const Vector3& dv) {
+        double lengthSquared = v.dot(v);
+        double length = std::sqrt(lengthSquared);
+        return (dv * lengthSquared - v * v.dot(dv)) / (lengthSquared * length);
+    }
+
+    // Transfere para o acerto em t sobre o plano tangente de normal n: as
+    // origens passam a ser dP/dx e dP/dy no ponto, as direções não mudam.
+    // Raio rasante (direção quase no plano) mantém o deslocamento sem a
+    // correção de t, para não explodir.
+    RayDifferential transfer(const Ray& ray, double t, const Vector3& n) const {
+        RayDifferential result = *this;
+        Vector3 px = dOdx + dDdx * t;
+        Vector3 py = dOdy + dDdy * t;
+        double dn = ray.direction.dot(n);
+        if (std::fabs(dn) > 1e-6) {
+            px = px - ray.direction * (px.dot(n) / dn);
+            py = py - ray.direction * (py.dot(n) / dn);
+        }
+        result.dOdx = px;
+        result.dOdy = py;
+        return result;
+    }
+};
+
 #endif // RAY_H
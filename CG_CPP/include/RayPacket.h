@@ -0,0 +1,94 @@
+#ifndef RAYPACKET_H
+#define RAYPACKET_H
+
+#include "Ray.h"
+#include <cmath>
+#include <cstdint>
+
+#ifdef CG_SIMD_SSE
+#include <immintrin.h>
+#endif
+
+// Número de raios por pacote
+const int PACKET_SIZE = 8;
+
+// Registrador SIMD do alvo da compilação (SSE2 por padrão, AVX/AVX-512
+// com -march=native), limitado ao tamanho do pacote
+#if defined(__AVX512F__) && !defined(CG_USE_FLOAT)
+const int SIMD_BYTES = 64;
+#elif defined(__AVX__)
+const int SIMD_BYTES = 32;
+#else
+const int SIMD_BYTES = 16;
+#endif
+
+const int SIMD_WIDTH = SIMD_BYTES / sizeof(Real);    // Reals por registrador
+const int PACKET_CHUNKS = PACKET_SIZE / SIMD_WIDTH;  // Registradores por pacote
+
+// SIMD_WIDTH valores Real em um registrador (extensão de vetores do
+// GCC/Clang): aritmética e comparações valem posição a posição.
+// Comparações produzem SimdMask (todos os bits 1 = verdadeiro, 0 = falso),
+// usada com ?: para selecionar. O tipo tem exatamente a largura do
+// registrador: vetores mais largos fariam o GCC comparar posição a posição.
+typedef Real SimdReal __attribute__((vector_size(SIMD_BYTES)));
+typedef decltype(SimdReal() < SimdReal()) SimdMask;
+
+// Posição k de um valor de pacote guardado em PACKET_CHUNKS registradores
+inline Real packetLane(const SimdReal* chunks, int k) {
+    return chunks[k / SIMD_WIDTH][k % SIMD_WIDTH];
+}
+
+inline void setPacketLane(SimdReal* chunks, int k, Real value) {
+    chunks[k / SIMD_WIDTH][k % SIMD_WIDTH] = value;
+}
+
+// Raiz quadrada posição a posição (não há operador para isso nos vetores)
+inline SimdReal simdSqrt(SimdReal x) {
+#if defined(CG_SIMD_SSE) && defined(CG_USE_FLOAT)
+    for (int k = 0; k < SIMD_WIDTH; k += 4) {
+        Real* p = reinterpret_cast<Real*>(&x) + k;
+        _mm_storeu_ps(p, _mm_sqrt_ps(_mm_loadu_ps(p)));
+    }
+#elif defined(CG_SIMD_SSE)
+    for (int k = 0; k < SIMD_WIDTH; k += 2) {
+        Real* p = reinterpret_cast<Real*>(&x) + k;
+        _mm_storeu_pd(p, _mm_sqrt_pd(_mm_loadu_pd(p)));
+    }
+#else
+    for (int k = 0; k < SIMD_WIDTH; k++) {
+        x[k] = std::sqrt(x[k]);
+    }
+#endif
+    return x;
+}
+
+// PACOTE DE RAIOS (SoA)
+// Raios vizinhos (ex: pixels de uma linha do tile) guardados componente a
+// componente, SIMD_WIDTH raios por registrador, para que os intersectores
+// e a BVH testem vários raios por instrução.
+struct RayPacket {
+    SimdReal ox[PACKET_CHUNKS], oy[PACKET_CHUNKS], oz[PACKET_CHUNKS];
+    SimdReal dx[PACKET_CHUNKS], dy[PACKET_CHUNKS], dz[PACKET_CHUNKS];
+    SimdReal invDx[PACKET_CHUNKS], invDy[PACKET_CHUNKS], invDz[PACKET_CHUNKS];  // 1 / direção (slabs)
+
+    void set(int lane, const Ray& ray) {
+        setPacketLane(ox, lane, ray.origin.x);
+        setPacketLane(oy, lane, ray.origin.y);
+        setPacketLane(oz, lane, ray.origin.z);
+        setPacketLane(dx, lane, ray.direction.x);
+        setPacketLane(dy, lane, ray.direction.y);
+        setPacketLane(dz, lane, ray.direction.z);
+        setPacketLane(invDx, lane, ray.invDirection.x);
+        setPacketLane(invDy, lane, ray.invDirection.y);
+        setPacketLane(invDz, lane, ray.invDirection.z);
+    }
+
+    // Raio individual de uma posição (sem renormalizar a direção)
+    Ray get(int lane) const {
+        return Ray(Vector3(packetLane(ox, lane), packetLane(oy, lane), packetLane(oz, lane)),
+                   Vector3(packetLane(dx, lane), packetLane(dy, lane), packetLane(dz, lane)),
+                   RayDirection::UNIT);
+    }
+};
+
+#endif // RAYPACKET_H
@@ -0,0 +1,22 @@
+#ifndef REAL_H
+#define REAL_H
+
+// PRECISÃO DOS CÁLCULOS GEOMÉTRICOS
+// Por padrão Vector3 e Color usam double. Compilando com -DCG_USE_FLOAT
+// todo o ray tracer passa a usar float (metade da memória e o dobro de
+// componentes por registrador SIMD).
+#ifdef CG_USE_FLOAT
+typedef float Real;
+#else
+typedef double Real;
+#endif
+
+// CG_SIMD_SSE liga os intrínsecos SSE dos pacotes de raios (RayPacket.h).
+// Vector3 e Color ficam escalares: montar e desmontar um registrador a
+// cada operação isolada custa mais que a aritmética que ele economiza.
+// -DCG_NO_SIMD força a versão escalar.
+#if !defined(CG_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+#define CG_SIMD_SSE 1
+#endif
+
+#endif // REAL_H
@@ -5,6 +5,10 @@
 #include "Lights.h"
 #include "Camera.h"
 #include "Color.h"
+#include "BVH.h"
+#include "ThreadPool.h"
+#include "Framebuffer.h"
+#include "ImageIO.h"
 #include <vector>
 #include <memory>
 #include <string>
@@ -49,25 +53,74 @@ public:
     void addObject(std::shared_ptr<Object> obj);
     void addLight(std::shared_ptr<Light> light);
     void setAmbientLight(std::shared_ptr<AmbientLight> light);
-    
+
+    // Constrói a BVH sobre os objetos limitados. Deve ser chamada depois de
+    // adicionar os objetos; enquanto não for (ou após novo addObject), as
+    // consultas caem no teste linear.
+    void buildBVH();
+    bool hasBVH() const { return !bvhDirty; }
+
+    // Acerto mais próximo (só t/objeto/primitivo; a superfície é montada
+    // depois com rec.object->computeSurface)
     bool intersect(const Ray& ray, HitRecord& rec) const;
+
+    // Consulta any-hit: algum objeto bloqueia o raio antes de tMax?
+    bool occluded(const Ray& ray, double tMax) const;
     bool isInShadow(const Vector3& point, const Vector3& lightPos) const;
-    Color computeLighting(const HitRecord& hit, const Ray& ray) const;
+    Color computeLighting(const SurfaceRecord& surface, const Ray& ray) const;
     Color traceRay(const Ray& ray) const;
 
+    // Versões para pacotes de raios vizinhos (RayPacket.h)
+    void intersect(const RayPacket& packet, PacketHit& hit) const;
+    // Máscara (bit k = raio k) dos raios bloqueados antes do seu tMax; raios com tMax < 0 são ignorados
+    uint32_t occluded(const RayPacket& packet, const SimdReal* tMax) const;
+    // Traça os 'count' primeiros raios do pacote; sombras também em pacote, uma luz por vez
+    void tracePacket(const RayPacket& packet, int count, Color* colors) const;
+
     // Função de picking: retorna objeto atingido em coordenadas de pixel
     PickResult pick(const Camera& camera, int pixelX, int pixelY) const;
+
+private:
+    // shadowMasks: máscaras de sombra por luz (pontuais, depois spots) já
+    // calculadas em pacote; nullptr = testa cada luz com isInShadow
+    Color computeLighting(const SurfaceRecord& surface, const Ray& ray,
+                          const uint32_t* shadowMasks, int lane) const;
+    uint32_t shadowPacket(const SurfaceRecord* surfaces, const PacketHit& hit, int count,
+                          const Vector3& lightPos) const;
+
+    BVH bvh;
+    std::vector<const Object*> boundedObjects;    // Primitivos da BVH (indexados por ela)
+    std::vector<const Object*> unboundedObjects;  // Objetos infinitos (planos): teste linear
+    bool bvhDirty;
 };
 
 class Renderer {
 public:
     Scene& scene;
     Camera& camera;
-    
+    int tileSize;  // Lado do tile (pixels) distribuído para as threads
+    PPMFormat outputFormat;  // Padrão: P6 binário de 8 bits
+    bool streamOutput;       // Grava cada tile no disco assim que termina (sem imagem inteira na memória)
+    PixelFormat framebufferFormat;  // Padrão: RGB32F (float, metade da memória de Color)
+    bool packetTracing;      // Traça cada linha do tile em pacotes de PACKET_SIZE raios (padrão)
+
+    // Sem pool explícito, cria um com hardware_concurrency() threads.
+    // Vários renderers podem compartilhar o mesmo pool.
     Renderer(Scene& scene, Camera& camera);
-    
+    Renderer(Scene& scene, Camera& camera, std::shared_ptr<ThreadPool> pool);
+
+    void setThreadCount(int numThreads);  // 0 = hardware_concurrency()
+    int getThreadCount() const { return pool->size(); }
+
     void render(const std::string& filename);
-    void savePPM(const std::string& filename, const std::vector<std::vector<Color>>& image);
+    void savePPM(const std::string& filename, const Framebuffer& image);
+
+    // Última imagem renderizada (vazia no modo streaming)
+    const Framebuffer& getFramebuffer() const { return framebuffer; }
+
+private:
+    std::shared_ptr<ThreadPool> pool;
+    Framebuffer framebuffer;  // Reaproveitado entre chamadas de render
 };
 
 #endif // SCENE_H
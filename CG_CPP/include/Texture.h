@@ -3,29 +3,185 @@
 
 #include "Color.h"
 #include "Vector3.h"
+#include "ThreadPool.h"
+#include <cstdint>
+#include <future>
 #include <string>
 #include <memory>
+#include <vector>
 
+// Filtro de amostragem (nível de mip escolhido pelo LOD)
+enum class TextureFilter {
+    NEAREST,    // Texel mais próximo do nível round(lod)
+    BILINEAR,   // 4 texels do nível round(lod)
+    TRILINEAR   // Bilinear nos níveis floor(lod) e floor(lod) + 1, interpolado
+};
+
+// Ordem dos texels de cada nível na memória
+enum class TextureLayout {
+    LINEAR,  // Linha a linha: vizinhos verticais ficam a uma linha inteira de distância
+    TILED,   // Blocos 8x8 (256 bytes), linha a linha dentro do bloco e entre blocos
+    MORTON   // Blocos 8x8 com curva Z dentro do bloco: vizinhos em x e em y próximos
+};
+
+// Lado do bloco das organizações TILED e MORTON (texels)
+const int TEXTURE_TILE_SIZE = 8;
+
+// Versão do formato do cache de textura (ver Texture::loadCached)
+const uint32_t TEXTURE_CACHE_VERSION = 1;
+
+class MappedFile;
+
+// TEXTURA RGBA8 COM PIRÂMIDE DE MIPMAPS
+// Na carga são gerados os níveis 1..n por média 2x2 do nível anterior, até
+// 1x1, todos num único buffer. Amostrar um nível pequeno (LOD alto) para
+// superfícies distantes evita aliasing e lê poucos texels vizinhos, que
+// ficam no cache, em vez de pular pela imagem inteira.
+// Cada texel ocupa 4 bytes (RGBA, alfa preenchido): um texel nunca cruza
+// linha de cache e os 4 canais saem de um acesso alinhado. Em blocos (TILED,
+// MORTON) os 4 texels de uma amostra bilinear quase sempre caem no mesmo
+// bloco, seja qual for a direção em que o pé do raio anda na imagem.
 class Texture {
 private:
-    unsigned char* data;
-    int width;
-    int height;
-    int channels;
+    struct MipLevel {
+        int width;
+        int height;
+        int tilesX;     // Blocos por linha (TILED/MORTON; borda completada)
+        size_t offset;  // Início do nível em texels (4 bytes cada)
+    };
+
+    std::vector<unsigned char> texels;  // Todos os níveis, RGBA 8 bits
+    std::vector<MipLevel> levels;       // levels[0] = imagem original
+    TextureLayout layout;
     bool loaded;
 
+    // Texels lidos pela amostragem: texels.data(), ou direto do cache
+    // mapeado em memória (mapping), sem cópia
+    const unsigned char* pixels;
+    std::shared_ptr<const MappedFile> mapping;
+
+    void buildMipmaps();
+    bool writeCache(const std::string& filename, uint64_t sourceSize, int64_t sourceTime,
+                    uint64_t sourceHash) const;
+    bool readCache(const std::shared_ptr<const MappedFile>& file, const std::string& filename);
+    static size_t levelTexelCount(const MipLevel& level, TextureLayout layout);
+
+    // Posição de (x, y) no buffer na organização atual: nas três é a soma
+    // de uma parte que só depende da linha e outra que só depende da coluna,
+    // então a bilinear calcula 2 + 2 partes em vez de 4 endereços completos.
+    // Nos blocos, o bloco é (x >> 3, y >> 3); dentro dele, TILED usa
+    // y * 8 + x e MORTON intercala os bits (x nas posições pares, y nas ímpares).
+    size_t rowIndex(const MipLevel& level, int y) const {
+        if (layout == TextureLayout::LINEAR) {
+            return level.offset + static_cast<size_t>(y) * level.width;
+        }
+        size_t tileRow = static_cast<size_t>(y >> 3) * level.tilesX * (TEXTURE_TILE_SIZE * TEXTURE_TILE_SIZE);
+        int inTile = layout == TextureLayout::TILED ? (y & 7) << 3
+                                                    : ((y & 1) << 1) | ((y & 2) << 2) | ((y & 4) << 3);
+        return level.offset + tileRow + inTile;
+    }
+    size_t columnIndex(int x) const {
+        if (layout == TextureLayout::LINEAR) {
+            return x;
+        }
+        size_t tileColumn = static_cast<size_t>(x >> 3) * (TEXTURE_TILE_SIZE * TEXTURE_TILE_SIZE);
+        int inTile = layout == TextureLayout::TILED ? x & 7 : (x & 1) | ((x & 2) << 1) | ((x & 4) << 2);
+        return tileColumn + inTile;
+    }
+    const unsigned char* texel(size_t index) const {
+        return pixels + index * 4;
+    }
+    const unsigned char* texel(const MipLevel& level, int x, int y) const {
+        return texel(rowIndex(level, y) + columnIndex(x));
+    }
+    Color sampleNearest(const MipLevel& level, double u, double v) const;
+    Color sampleBilinear(const MipLevel& level, double u, double v) const;
+
 public:
     Texture();
     Texture(const std::string& filename);
     ~Texture();
 
-    bool load(const std::string& filename);
-    Color sample(double u, double v) const;  // UV em [0, 1]
+    bool load(const std::string& filename, TextureLayout layout = TextureLayout::TILED);
+
+    // Reorganiza os texels de todos os níveis (mesmas cores; só muda a ordem)
+    void setLayout(TextureLayout newLayout);
+    TextureLayout getLayout() const { return layout; }
+
+    // CACHE DE TEXTURA PRÉ-CONVERTIDA
+    // A pirâmide inteira (RGBA8, já na organização da textura) é gravada
+    // como está na memória: cabeçalho, tabela de níveis e texels alinhados a
+    // 64 bytes. A leitura mapeia o arquivo e amostra direto do mapeamento,
+    // sem decodificar JPEG, sem gerar mipmaps e sem copiar os texels: o
+    // sistema operacional só lê as páginas que os raios realmente tocam.
+    // loadCached usa cacheFilename (padrão: filename + ".cache", ao lado da
+    // imagem) se ele veio da imagem atual: mesmo tamanho e, se a data de
+    // modificação mudou, mesmo hash (FNV-1a) do conteúdo. Senão decodifica
+    // a imagem e regrava o cache. Um cache de outra organização é
+    // reorganizado e regravado na organização pedida.
+    bool saveCache(const std::string& cacheFilename) const;
+    bool loadCache(const std::string& cacheFilename);
+    bool loadCached(const std::string& filename, TextureLayout layout = TextureLayout::TILED,
+                    const std::string& cacheFilename = "");
+    Color sample(double u, double v) const;  // UV em [0, 1], texel mais próximo do nível 0
+
+    // UV com repetição; lod em níveis de mip (0 = resolução original,
+    // cada +1 divide a resolução por 2), limitado aos níveis existentes
+    Color sample(double u, double v, double lod, TextureFilter filter = TextureFilter::TRILINEAR) const;
+
     bool isLoaded() const { return loaded; }
+    int getWidth() const { return levels.empty() ? 0 : levels[0].width; }
+    int getHeight() const { return levels.empty() ? 0 : levels[0].height; }
+    int levelCount() const { return static_cast<int>(levels.size()); }
 
-    // Evita cópia acidental (textura pode ser grande)
+    // Evita cópia acidental (textura pode ser grande); mover é barato
     Texture(const Texture&) = delete;
     Texture& operator=(const Texture&) = delete;
+    Texture(Texture&&) = default;
+    Texture& operator=(Texture&&) = default;
+};
+
+// CARREGAMENTO ASSÍNCRONO DE TEXTURAS
+// load() só enfileira a carga (Texture::loadCached: cache pré-convertido ou
+// stb_image, mipmaps e reorganização em blocos) numa thread do pool e
+// retorna na hora: várias texturas são
+// decodificadas ao mesmo tempo, e a espera total é a da maior, não a soma.
+// Cada textura é montada num objeto próprio; o destino só é trocado por
+// install(), chamado pela thread principal entre quadros, então os raios
+// nunca leem uma textura pela metade. Até lá o destino continua como
+// estava (vazio: isLoaded() falso, o material usa a cor sólida).
+// O pool precisa existir até o fim do loader; o destrutor espera as
+// decodificações em andamento.
+class TextureLoader {
+public:
+    explicit TextureLoader(ThreadPool& pool);
+    ~TextureLoader();
+
+    void load(const std::string& filename, Texture& target, TextureLayout layout = TextureLayout::TILED);
+
+    // Move para os destinos as texturas já decodificadas (sem bloquear).
+    // Retorna quantos destinos mudaram; falhas de leitura não contam.
+    int install();
+
+    // Espera todas as decodificações e instala (uso sem janela/quadros)
+    void finish();
+
+    // Texturas pedidas ainda não instaladas
+    int pending() const { return static_cast<int>(jobs.size()); }
+
+    TextureLoader(const TextureLoader&) = delete;
+    TextureLoader& operator=(const TextureLoader&) = delete;
+
+private:
+    struct Job {
+        Texture* target;
+        std::unique_ptr<Texture> texture;
+        bool loaded;
+        std::future<void> done;
+    };
+
+    ThreadPool& pool;
+    std::vector<std::unique_ptr<Job>> jobs;
 };
 
 // Classe gerenciadora de texturas (singleton pattern)
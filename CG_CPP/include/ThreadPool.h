@@ -0,0 +1,64 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// POOL DE THREADS PERSISTENTE
+// As threads são criadas uma vez e reutilizadas a cada parallelFor.
+// O trabalho é distribuído dinamicamente por um contador atômico: cada
+// thread pega o próximo índice livre (ex: próximo tile), o que equilibra
+// a carga mesmo quando alguns tiles são muito mais caros que outros.
+// Tarefas avulsas (submit) rodam em segundo plano nas threads criadas,
+// intercaladas com os lotes: uma thread livre dá preferência ao lote atual.
+class ThreadPool {
+public:
+    // numThreads = 0 usa std::thread::hardware_concurrency()
+    // A thread chamadora também trabalha, então são criadas numThreads - 1 threads
+    explicit ThreadPool(int numThreads = 0);
+    ~ThreadPool();
+
+    // Número total de threads que executam tarefas (inclui a chamadora)
+    int size() const { return static_cast<int>(workers.size()) + 1; }
+
+    // Executa task(i) para todo i em [0, count) e bloqueia até terminar.
+    // Não é reentrante: task não deve chamar parallelFor no mesmo pool.
+    void parallelFor(int count, const std::function<void(int)>& task);
+
+    // Enfileira task para a próxima thread livre e retorna sem esperar; o
+    // future indica o fim (e repassa exceções). Sem threads criadas
+    // (pool de tamanho 1), executa na hora. Tarefas ainda na fila quando o
+    // pool é destruído são descartadas (future com broken_promise).
+    std::future<void> submit(std::function<void()> task);
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable doneCondition;
+
+    // Lote atual (protegido por mutex, exceto nextIndex)
+    const std::function<void(int)>* currentTask;
+    int taskCount;
+    std::atomic<int> nextIndex;
+    int busyWorkers;
+    uint64_t generation;
+    bool stopping;
+
+    std::deque<std::packaged_task<void()>> jobs;  // Tarefas avulsas (protegidas por mutex)
+
+    void workerLoop();
+    void runTasks(const std::function<void(int)>& task, int count);
+};
+
+#endif // THREADPOOL_H
@@ -1,46 +1,55 @@
 #ifndef VECTOR3_H
 #define VECTOR3_H
 
+#include "Real.h"
 #include <cmath>
 #include <iostream>
 
-class Vector3 {
+// Vetor 3D genérico na precisão T (float ou double).
+// O restante do código usa o alias Vector3 = Vector3T<Real>.
+template <typename T>
+class Vector3T {
 public:
-    double x, y, z;
+    T x, y, z;
 
     // Construtores
-    Vector3() : x(0), y(0), z(0) {}
-    Vector3(double x, double y, double z) : x(x), y(y), z(z) {}
+    Vector3T() : x(0), y(0), z(0) {}
+    Vector3T(T x, T y, T z) : x(x), y(y), z(z) {}
+
+    // Conversão explícita entre precisões
+    template <typename U>
+    explicit Vector3T(const Vector3T<U>& v)
+        : x(static_cast<T>(v.x)), y(static_cast<T>(v.y)), z(static_cast<T>(v.z)) {}
 
     // Operadores
-    Vector3 operator+(const Vector3& v) const {
-        return Vector3(x + v.x, y + v.y, z + v.z);
+    Vector3T operator+(const Vector3T& v) const {
+        return Vector3T(x + v.x, y + v.y, z + v.z);
     }
 
-    Vector3 operator-(const Vector3& v) const {
-        return Vector3(x - v.x, y - v.y, z - v.z);
+    Vector3T operator-(const Vector3T& v) const {
+        return Vector3T(x - v.x, y - v.y, z - v.z);
     }
 
-    Vector3 operator*(double t) const {
-        return Vector3(x * t, y * t, z * t);
+    Vector3T operator*(T t) const {
+        return Vector3T(x * t, y * t, z * t);
     }
 
-    Vector3 operator/(double t) const {
-        return Vector3(x / t, y / t, z / t);
+    Vector3T operator/(T t) const {
+        return Vector3T(x / t, y / t, z / t);
     }
 
-    Vector3 operator-() const {
-        return Vector3(-x, -y, -z);
+    Vector3T operator-() const {
+        return Vector3T(-x, -y, -z);
     }
 
     // Produto escalar
-    double dot(const Vector3& v) const {
+    T dot(const Vector3T& v) const {
         return x * v.x + y * v.y + z * v.z;
     }
 
     // Produto vetorial
-    Vector3 cross(const Vector3& v) const {
-        return Vector3(
+    Vector3T cross(const Vector3T& v) const {
+        return Vector3T(
             y * v.z - z * v.y,
             z * v.x - x * v.z,
             x * v.y - y * v.x
@@ -48,58 +57,56 @@ public:
     }
 
     // Comprimento
-    double length() const {
+    T length() const {
         return std::sqrt(x * x + y * y + z * z);
     }
 
-    double lengthSquared() const {
+    T lengthSquared() const {
         return x * x + y * y + z * z;
     }
 
     // Normalização
-    Vector3 normalized() const {
-        double len = length();
+    Vector3T normalized() const {
+        T len = length();
         if (len > 0) {
             return *this / len;
         }
-        return Vector3(0, 0, 0);
+        return Vector3T(0, 0, 0);
     }
 
     void normalize() {
-        double len = length();
-        if (len > 0) {
-            x /= len;
-            y /= len;
-            z /= len;
-        }
+        *this = normalized();
     }
 
     // Reflexão
-    Vector3 reflect(const Vector3& normal) const {
+    Vector3T reflect(const Vector3T& normal) const {
         return *this - normal * 2 * this->dot(normal);
     }
 
     // Acesso por índice
-    double operator[](int i) const {
+    T operator[](int i) const {
         if (i == 0) return x;
         if (i == 1) return y;
         return z;
     }
 
-    double& operator[](int i) {
+    T& operator[](int i) {
         if (i == 0) return x;
         if (i == 1) return y;
         return z;
     }
+
+    // Multiplicação escalar à esquerda (friend: aceita escalares de outro tipo)
+    friend Vector3T operator*(T t, const Vector3T& v) {
+        return v * t;
+    }
 };
 
-// Operador de multiplicação escalar à esquerda
-inline Vector3 operator*(double t, const Vector3& v) {
-    return v * t;
-}
+typedef Vector3T<Real> Vector3;
 
 // Operador de saída
-inline std::ostream& operator<<(std::ostream& out, const Vector3& v) {
+template <typename T>
+inline std::ostream& operator<<(std::ostream& out, const Vector3T<T>& v) {
     return out << "Vector3(" << v.x << ", " << v.y << ", " << v.z << ")";
 }
 
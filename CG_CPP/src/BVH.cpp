@@ -0,0 +1,154 @@
+#include "../include/BVH.h"
+#include <algorithm>
+
+namespace {
+    const int SAH_BINS = 12;
+
+    struct Bin {
+        AABB bounds;
+        uint32_t count = 0;
+    };
+}
+
+void BVH::clear() {
+    nodes.clear();
+    indices.clear();
+}
+
+void BVH::build(const std::vector<AABB>& primitiveBounds, int maxLeafSize, int leafBatch) {
+    clear();
+    if (primitiveBounds.empty()) return;
+
+    uint32_t n = static_cast<uint32_t>(primitiveBounds.size());
+    indices.resize(n);
+    std::vector<Vector3> centroids(n);
+    for (uint32_t i = 0; i < n; i++) {
+        indices[i] = i;
+        centroids[i] = primitiveBounds[i].centroid();
+    }
+
+    // Uma árvore binária com n folhas tem no máximo 2n - 1 nós
+    nodes.reserve(2 * n - 1);
+    BVHNode root;
+    root.leftFirst = 0;
+    root.count = n;
+    nodes.push_back(root);
+    updateBounds(0, primitiveBounds);
+
+    // Subdivisão iterativa (evita recursão profunda em malhas grandes)
+    std::vector<std::pair<uint32_t, int>> pending;
+    pending.push_back({0, 0});
+    while (!pending.empty()) {
+        auto [nodeIndex, depth] = pending.back();
+        pending.pop_back();
+
+        if (depth >= BVH::MAX_DEPTH) continue;
+
+        size_t before = nodes.size();
+        subdivide(nodeIndex, primitiveBounds, centroids, maxLeafSize, leafBatch);
+        if (nodes.size() > before) {
+            pending.push_back({nodes[nodeIndex].leftFirst, depth + 1});
+            pending.push_back({nodes[nodeIndex].leftFirst + 1, depth + 1});
+        }
+    }
+}
+
+void BVH::updateBounds(uint32_t nodeIndex, const std::vector<AABB>& primitiveBounds) {
+    BVHNode& node = nodes[nodeIndex];
+    node.bounds = AABB();
+    for (uint32_t i = 0; i < node.count; i++) {
+        node.bounds.expand(primitiveBounds[indices[node.leftFirst + i]]);
+    }
+}
+
+// Divide uma folha em dois filhos se o custo SAH compensar
+void BVH::subdivide(uint32_t nodeIndex, const std::vector<AABB>& primitiveBounds,
+                    const std::vector<Vector3>& centroids, int maxLeafSize, int leafBatch) {
+    BVHNode node = nodes[nodeIndex];
+    if (node.count <= 1) return;
+
+    // Caixa dos centróides: define o intervalo dos bins
+    AABB centroidBounds;
+    for (uint32_t i = 0; i < node.count; i++) {
+        centroidBounds.expand(centroids[indices[node.leftFirst + i]]);
+    }
+
+    int bestAxis = -1;
+    int bestSplit = 0;
+    double bestCost = std::numeric_limits<double>::max();
+
+    for (int axis = 0; axis < 3; axis++) {
+        double lo = centroidBounds.minPoint[axis];
+        double hi = centroidBounds.maxPoint[axis];
+        if (hi <= lo) continue;
+
+        Bin bins[SAH_BINS];
+        double scale = SAH_BINS / (hi - lo);
+        for (uint32_t i = 0; i < node.count; i++) {
+            uint32_t prim = indices[node.leftFirst + i];
+            int b = std::min(SAH_BINS - 1, static_cast<int>((centroids[prim][axis] - lo) * scale));
+            bins[b].count++;
+            bins[b].bounds.expand(primitiveBounds[prim]);
+        }
+
+        // Varredura da esquerda e da direita acumulando áreas e contagens
+        double leftArea[SAH_BINS - 1], rightArea[SAH_BINS - 1];
+        uint32_t leftCount[SAH_BINS - 1], rightCount[SAH_BINS - 1];
+        AABB leftBox, rightBox;
+        uint32_t leftSum = 0, rightSum = 0;
+        for (int i = 0; i < SAH_BINS - 1; i++) {
+            leftSum += bins[i].count;
+            leftCount[i] = leftSum;
+            leftBox.expand(bins[i].bounds);
+            leftArea[i] = leftBox.surfaceArea();
+
+            rightSum += bins[SAH_BINS - 1 - i].count;
+            rightCount[SAH_BINS - 2 - i] = rightSum;
+            rightBox.expand(bins[SAH_BINS - 1 - i].bounds);
+            rightArea[SAH_BINS - 2 - i] = rightBox.surfaceArea();
+        }
+
+        for (int i = 0; i < SAH_BINS - 1; i++) {
+            if (leftCount[i] == 0 || rightCount[i] == 0) continue;
+            double cost = leftCount[i] * leftArea[i] + rightCount[i] * rightArea[i];
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = i;
+            }
+        }
+    }
+
+    if (bestAxis < 0) return;  // Centróides coincidentes: mantém como folha
+
+    // Só divide se for mais barato que testar todos os primitivos da folha
+    uint32_t leafTests = (node.count + leafBatch - 1) / leafBatch;
+    double leafCost = leafTests * node.bounds.surfaceArea();
+    if (bestCost >= leafCost && node.count <= static_cast<uint32_t>(maxLeafSize)) return;
+
+    // Particiona os índices em torno do plano escolhido
+    double lo = centroidBounds.minPoint[bestAxis];
+    double scale = SAH_BINS / (centroidBounds.maxPoint[bestAxis] - lo);
+    auto first = indices.begin() + node.leftFirst;
+    auto middle = std::partition(first, first + node.count, [&](uint32_t prim) {
+        int b = std::min(SAH_BINS - 1, static_cast<int>((centroids[prim][bestAxis] - lo) * scale));
+        return b <= bestSplit;
+    });
+
+    uint32_t leftCount = static_cast<uint32_t>(middle - first);
+    if (leftCount == 0 || leftCount == node.count) return;
+
+    uint32_t leftIndex = static_cast<uint32_t>(nodes.size());
+    BVHNode leftChild, rightChild;
+    leftChild.leftFirst = node.leftFirst;
+    leftChild.count = leftCount;
+    rightChild.leftFirst = node.leftFirst + leftCount;
+    rightChild.count = node.count - leftCount;
+    nodes.push_back(leftChild);
+    nodes.push_back(rightChild);
+    updateBounds(leftIndex, primitiveBounds);
+    updateBounds(leftIndex + 1, primitiveBounds);
+
+    nodes[nodeIndex].leftFirst = leftIndex;
+    nodes[nodeIndex].count = 0;
+}
@@ -46,7 +46,7 @@ Ray Camera::getRay(int i, int j) const {
             // Projeção perspectiva (padrão)
             Vector3 pointOnPlane = eye - w * d + u * x + v * y;
             Vector3 direction = (pointOnPlane - eye).normalized();
-            return Ray(eye, direction);
+            return Ray(eye, direction, RayDirection::UNIT);
         }
 
         case ProjectionType::ORTHOGRAPHIC: {
@@ -54,7 +54,7 @@ Ray Camera::getRay(int i, int j) const {
             // Origem do raio varia, mas direção é sempre -w
             Vector3 origin = eye + u * x + v * y;
             Vector3 direction = -w;  // Todos os raios apontam na mesma direção
-            return Ray(origin, direction);
+            return Ray(origin, direction, RayDirection::UNIT);
         }
 
         case ProjectionType::OBLIQUE: {
@@ -67,17 +67,49 @@ Ray Camera::getRay(int i, int j) const {
                                       + v * obliqueFactor * std::sin(angleRad)).normalized();
 
             Vector3 origin = eye + u * x + v * y;
-            return Ray(origin, obliqueDir);
+            return Ray(origin, obliqueDir, RayDirection::UNIT);
         }
 
         default:
             // Fallback para perspectiva
             Vector3 pointOnPlane = eye - w * d + u * x + v * y;
             Vector3 direction = (pointOnPlane - eye).normalized();
-            return Ray(eye, direction);
+            return Ray(eye, direction, RayDirection::UNIT);
     }
 }
 
+// ============ GERADOR DE RAIOS PRIMÁRIOS ============
+
+CameraRayGenerator::CameraRayGenerator(const Camera& camera)
+    : projectionType(camera.projectionType), eye(camera.eye),
+      planeStart(camera.eye - camera.w * camera.d),
+      parallelDirection(-camera.w),
+      columnTerms(camera.imageWidth), rowTerms(camera.imageHeight) {
+    if (projectionType == ProjectionType::OBLIQUE) {
+        double angleRad = camera.obliqueAngle * M_PI / 180.0;
+        parallelDirection = (-camera.w + camera.u * camera.obliqueFactor * std::cos(angleRad)
+                                        + camera.v * camera.obliqueFactor * std::sin(angleRad)).normalized();
+    } else if (projectionType != ProjectionType::ORTHOGRAPHIC) {
+        // Tipos desconhecidos caem na perspectiva, como em Camera::getRay
+        projectionType = ProjectionType::PERSPECTIVE;
+    }
+
+    // Mesmas coordenadas de janela de Camera::getRay
+    for (int i = 0; i < camera.imageWidth; i++) {
+        double uCoord = (i + 0.5) / camera.imageWidth;
+        double x = (uCoord - 0.5) * camera.viewWidth;
+        columnTerms[i] = camera.u * x;
+    }
+    for (int j = 0; j < camera.imageHeight; j++) {
+        double vCoord = (j + 0.5) / camera.imageHeight;
+        double y = (0.5 - vCoord) * camera.viewHeight;  // Inverte Y
+        rowTerms[j] = camera.v * y;
+    }
+
+    columnStep = camera.u * (camera.viewWidth / camera.imageWidth);
+    rowStep = camera.v * (-camera.viewHeight / camera.imageHeight);
+}
+
 void Camera::zoom(double factor) {
     viewWidth *= factor;
     viewHeight *= factor;
@@ -0,0 +1,189 @@
+#include "../include/Framebuffer.h"
+#include <algorithm>
+#include <cstring>
+
+int pixelFormatSize(PixelFormat format) {
+    switch (format) {
+        case PixelFormat::RGB32F: return 3 * sizeof(float);
+        case PixelFormat::RGBA16F: return 4 * sizeof(uint16_t);
+        case PixelFormat::RGBA8: return 4;
+    }
+    return 0;
+}
+
+// ============ HALF FLOAT ============
+
+uint16_t floatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t sign = (bits >> 16) & 0x8000;
+    int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFF) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    // Inf / NaN
+    if (((bits >> 23) & 0xFF) == 0xFF) {
+        return static_cast<uint16_t>(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+    }
+
+    // Grande demais: satura em infinito
+    if (exponent >= 31) {
+        return static_cast<uint16_t>(sign | 0x7C00);
+    }
+
+    // Subnormal (ou zero) em half
+    if (exponent <= 0) {
+        if (exponent < -10) return static_cast<uint16_t>(sign);
+        mantissa |= 0x800000;
+        uint32_t shift = static_cast<uint32_t>(14 - exponent);
+        uint32_t half = mantissa >> shift;
+        uint32_t remainder = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half & 1))) half++;
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    // Normal: arredonda para o par mais próximo (o carry pode subir o expoente)
+    uint32_t half = (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+    uint32_t remainder = mantissa & 0x1FFF;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) half++;
+    return static_cast<uint16_t>(sign | half);
+}
+
+float halfToFloat(uint16_t value) {
+    uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+    uint32_t exponent = (value >> 10) & 0x1F;
+    uint32_t mantissa = value & 0x3FF;
+    uint32_t bits;
+
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            bits = sign;
+        } else {
+            // Subnormal: normaliza a mantissa
+            exponent = 127 - 15 + 1;
+            while (!(mantissa & 0x400)) {
+                mantissa <<= 1;
+                exponent--;
+            }
+            bits = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+        }
+    } else if (exponent == 31) {
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+    }
+
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+// ============ FRAMEBUFFER ============
+
+static inline uint8_t quantize8(double c) {
+    c = std::max(0.0, std::min(1.0, c));
+    return static_cast<uint8_t>(std::min(255u, static_cast<unsigned>(255.99 * c)));
+}
+
+Framebuffer::Framebuffer() : width(0), height(0), stride(0), format(PixelFormat::RGB32F) {}
+
+Framebuffer::Framebuffer(int width, int height, PixelFormat format)
+    : width(0), height(0), stride(0), format(format) {
+    resize(width, height, format);
+}
+
+void Framebuffer::resize(int width, int height, PixelFormat format) {
+    this->width = std::max(0, width);
+    this->height = std::max(0, height);
+    this->format = format;
+
+    size_t rowBytes = static_cast<size_t>(this->width) * pixelFormatSize(format);
+    stride = (rowBytes + ROW_ALIGNMENT - 1) / ROW_ALIGNMENT * ROW_ALIGNMENT;
+
+    storage.assign(stride * this->height / ROW_ALIGNMENT, CacheLine());
+}
+
+void Framebuffer::setPixel(int x, int y, const Color& color) {
+    writeSpan(x, y, &color, 1);
+}
+
+Color Framebuffer::getPixel(int x, int y) const {
+    Color color;
+    readSpan(x, y, &color, 1);
+    return color;
+}
+
+void Framebuffer::writeSpan(int x, int y, const Color* pixels, int count) {
+    uint8_t* dst = row(y) + static_cast<size_t>(x) * pixelFormatSize(format);
+
+    switch (format) {
+        case PixelFormat::RGB32F: {
+            float* out = reinterpret_cast<float*>(dst);
+            for (int i = 0; i < count; i++) {
+                *out++ = static_cast<float>(pixels[i].r);
+                *out++ = static_cast<float>(pixels[i].g);
+                *out++ = static_cast<float>(pixels[i].b);
+            }
+            break;
+        }
+        case PixelFormat::RGBA16F: {
+            uint16_t* out = reinterpret_cast<uint16_t*>(dst);
+            for (int i = 0; i < count; i++) {
+                *out++ = floatToHalf(static_cast<float>(pixels[i].r));
+                *out++ = floatToHalf(static_cast<float>(pixels[i].g));
+                *out++ = floatToHalf(static_cast<float>(pixels[i].b));
+                *out++ = 0x3C00;  // alpha = 1.0
+            }
+            break;
+        }
+        case PixelFormat::RGBA8: {
+            for (int i = 0; i < count; i++) {
+                *dst++ = quantize8(pixels[i].r);
+                *dst++ = quantize8(pixels[i].g);
+                *dst++ = quantize8(pixels[i].b);
+                *dst++ = 255;
+            }
+            break;
+        }
+    }
+}
+
+void Framebuffer::readSpan(int x, int y, Color* pixels, int count) const {
+    const uint8_t* src = row(y) + static_cast<size_t>(x) * pixelFormatSize(format);
+
+    switch (format) {
+        case PixelFormat::RGB32F: {
+            const float* in = reinterpret_cast<const float*>(src);
+            for (int i = 0; i < count; i++, in += 3) {
+                pixels[i] = Color(in[0], in[1], in[2]);
+            }
+            break;
+        }
+        case PixelFormat::RGBA16F: {
+            const uint16_t* in = reinterpret_cast<const uint16_t*>(src);
+            for (int i = 0; i < count; i++, in += 4) {
+                pixels[i] = Color(halfToFloat(in[0]), halfToFloat(in[1]), halfToFloat(in[2]));
+            }
+            break;
+        }
+        case PixelFormat::RGBA8: {
+            for (int i = 0; i < count; i++, src += 4) {
+                pixels[i] = Color(src[0] / 255.0, src[1] / 255.0, src[2] / 255.0);
+            }
+            break;
+        }
+    }
+}
+
+void Framebuffer::clear(const Color& color) {
+    if (empty()) return;
+
+    // Preenche a primeira linha e replica os bytes nas demais
+    for (int x = 0; x < width; x++) {
+        setPixel(x, 0, color);
+    }
+    for (int y = 1; y < height; y++) {
+        std::memcpy(row(y), row(0), stride);
+    }
+}
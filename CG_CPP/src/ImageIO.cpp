@@ -0,0 +1,201 @@
+#include "../include/ImageIO.h"
+#include <algorithm>
+#include <iostream>
+#include <cstdio>
+#include <sstream>
+
+// Quantiza [0, 1] para [0, maxValue] (mesma regra 255.99 * c do writer P3 original)
+static inline unsigned quantize(double c, double scale, unsigned maxValue) {
+    c = std::max(0.0, std::min(1.0, c));
+    return std::min(maxValue, static_cast<unsigned>(scale * c));
+}
+
+static std::string ppmHeader(int width, int height, PPMFormat format) {
+    std::ostringstream header;
+    header << (format == PPMFormat::ASCII_P3 ? "P3" : "P6") << "\n"
+           << width << " " << height << "\n"
+           << (format == PPMFormat::BINARY_P6_16 ? 65535 : 255) << "\n";
+    return header.str();
+}
+
+static std::ofstream openPPM(const std::string& filename, int width, int height, PPMFormat format) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Erro ao abrir arquivo: " << filename << std::endl;
+        return file;
+    }
+
+    std::string header = ppmHeader(width, height, format);
+    file.write(header.data(), header.size());
+    return file;
+}
+
+static void appendP3Pixels(std::string& body, const Color* pixels, size_t count) {
+    char line[32];
+    for (size_t i = 0; i < count; i++) {
+        int n = std::snprintf(line, sizeof(line), "%u %u %u\n",
+                              quantize(pixels[i].r, 255.99, 255),
+                              quantize(pixels[i].g, 255.99, 255),
+                              quantize(pixels[i].b, 255.99, 255));
+        body.append(line, n);
+    }
+}
+
+int ppmBytesPerPixel(PPMFormat format) {
+    switch (format) {
+        case PPMFormat::BINARY_P6: return 3;
+        case PPMFormat::BINARY_P6_16: return 6;
+        default: return 0;
+    }
+}
+
+void encodePPMPixels(const Color* pixels, int count, PPMFormat format, uint8_t* out) {
+    if (format == PPMFormat::BINARY_P6_16) {
+        for (int i = 0; i < count; i++) {
+            const Color& c = pixels[i];
+            unsigned channels[3] = {
+                quantize(c.r, 65535.99, 65535),
+                quantize(c.g, 65535.99, 65535),
+                quantize(c.b, 65535.99, 65535)
+            };
+            for (int k = 0; k < 3; k++) {
+                *out++ = static_cast<uint8_t>(channels[k] >> 8);  // PPM 16 bits: MSB primeiro
+                *out++ = static_cast<uint8_t>(channels[k] & 0xFF);
+            }
+        }
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        const Color& c = pixels[i];
+        *out++ = static_cast<uint8_t>(quantize(c.r, 255.99, 255));
+        *out++ = static_cast<uint8_t>(quantize(c.g, 255.99, 255));
+        *out++ = static_cast<uint8_t>(quantize(c.b, 255.99, 255));
+    }
+}
+
+bool writePPM(const std::string& filename, const Color* pixels, int width, int height, PPMFormat format) {
+    std::ofstream file = openPPM(filename, width, height, format);
+    if (!file.is_open()) return false;
+
+    size_t count = static_cast<size_t>(width) * height;
+
+    if (format == PPMFormat::ASCII_P3) {
+        std::string body;
+        body.reserve(count * 12);
+        appendP3Pixels(body, pixels, count);
+        file.write(body.data(), body.size());
+    } else {
+        std::vector<uint8_t> body(count * ppmBytesPerPixel(format));
+        encodePPMPixels(pixels, static_cast<int>(count), format, body.data());
+        file.write(reinterpret_cast<const char*>(body.data()), body.size());
+    }
+
+    return static_cast<bool>(file);
+}
+
+bool writePPM(const std::string& filename, const Framebuffer& framebuffer, PPMFormat format) {
+    int width = framebuffer.getWidth();
+    int height = framebuffer.getHeight();
+
+    std::ofstream file = openPPM(filename, width, height, format);
+    if (!file.is_open()) return false;
+
+    std::vector<Color> rowPixels(width);
+    std::string body;
+
+    if (format == PPMFormat::ASCII_P3) {
+        body.reserve(static_cast<size_t>(width) * height * 12);
+        for (int y = 0; y < height; y++) {
+            framebuffer.readSpan(0, y, rowPixels.data(), width);
+            appendP3Pixels(body, rowPixels.data(), width);
+        }
+    } else {
+        size_t rowBytes = static_cast<size_t>(width) * ppmBytesPerPixel(format);
+        body.resize(rowBytes * height);
+        uint8_t* out = reinterpret_cast<uint8_t*>(&body[0]);
+
+        for (int y = 0; y < height; y++, out += rowBytes) {
+            if (framebuffer.getFormat() == PixelFormat::RGBA8 && format == PPMFormat::BINARY_P6) {
+                // Já quantizado com a mesma regra: só descarta o alfa
+                const uint8_t* in = framebuffer.row(y);
+                for (int x = 0; x < width; x++, in += 4) {
+                    out[x * 3 + 0] = in[0];
+                    out[x * 3 + 1] = in[1];
+                    out[x * 3 + 2] = in[2];
+                }
+            } else {
+                framebuffer.readSpan(0, y, rowPixels.data(), width);
+                encodePPMPixels(rowPixels.data(), width, format, out);
+            }
+        }
+    }
+
+    file.write(body.data(), body.size());
+    return static_cast<bool>(file);
+}
+
+// ============ ESCRITA INCREMENTAL ============
+
+PPMStreamWriter::PPMStreamWriter()
+    : headerSize(0), width(0), height(0), format(PPMFormat::BINARY_P6) {}
+
+PPMStreamWriter::~PPMStreamWriter() {
+    close();
+}
+
+bool PPMStreamWriter::open(const std::string& filename, int width, int height, PPMFormat format) {
+    close();
+
+    if (format == PPMFormat::ASCII_P3) {
+        std::cerr << "Escrita incremental requer PPM binario (P6)" << std::endl;
+        return false;
+    }
+
+    // Sem pixels, a reserva do arquivo voltaria para dentro do cabeçalho
+    if (width <= 0 || height <= 0) {
+        std::cerr << "Dimensoes invalidas para PPM: " << width << "x" << height << std::endl;
+        return false;
+    }
+
+    file.open(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Erro ao abrir arquivo: " << filename << std::endl;
+        return false;
+    }
+
+    this->width = width;
+    this->height = height;
+    this->format = format;
+
+    std::string header = ppmHeader(width, height, format);
+    file.write(header.data(), header.size());
+    headerSize = static_cast<std::streamoff>(header.size());
+
+    // Reserva o arquivo inteiro: trechos podem chegar fora de ordem
+    std::streamoff total = headerSize + static_cast<std::streamoff>(width) * height * ppmBytesPerPixel(format);
+    file.seekp(total - 1);
+    file.put('\0');
+
+    return static_cast<bool>(file);
+}
+
+void PPMStreamWriter::writeSpan(int x, int y, const Color* pixels, int count) {
+    int bytesPerPixel = ppmBytesPerPixel(format);
+
+    // Conversão fora do lock; só o seek + write são serializados
+    std::vector<uint8_t> bytes(static_cast<size_t>(count) * bytesPerPixel);
+    encodePPMPixels(pixels, count, format, bytes.data());
+
+    std::streamoff offset = headerSize + (static_cast<std::streamoff>(y) * width + x) * bytesPerPixel;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    file.seekp(offset);
+    file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+bool PPMStreamWriter::close() {
+    if (!file.is_open()) return true;
+    file.close();
+    return !file.fail();
+}
@@ -0,0 +1,65 @@
+#include "../include/MappedFile.h"
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile() : bytes(nullptr), length(0), opened(false) {}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& filename) {
+    close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Erro ao abrir arquivo: " << filename << std::endl;
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        std::cerr << "Erro ao ler tamanho do arquivo: " << filename << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    length = static_cast<size_t>(info.st_size);
+    if (length > 0) {
+        void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            std::cerr << "Erro ao mapear arquivo: " << filename << std::endl;
+            ::close(fd);
+            length = 0;
+            return false;
+        }
+        // Leitura em blocos grandes: as threads percorrem o arquivo inteiro
+        madvise(mapping, length, MADV_WILLNEED);
+        bytes = static_cast<const char*>(mapping);
+    }
+
+    // O mapeamento continua válido depois de fechar o descritor
+    ::close(fd);
+    opened = true;
+    return true;
+}
+
+bool fileStamp(const std::string& filename, uint64_t& size, int64_t& time) {
+    struct stat info;
+    if (stat(filename.c_str(), &info) != 0) return false;
+    size = static_cast<uint64_t>(info.st_size);
+    time = static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+    return true;
+}
+
+void MappedFile::close() {
+    if (bytes) {
+        munmap(const_cast<char*>(bytes), length);
+    }
+    bytes = nullptr;
+    length = 0;
+    opened = false;
+}
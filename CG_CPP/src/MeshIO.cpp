@@ -0,0 +1,597 @@
+#include "../include/MeshIO.h"
+#include "../include/MappedFile.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <type_traits>
+#include <unordered_map>
+
+namespace {
+    const size_t MIN_CHUNK_BYTES = 256 * 1024;  // Abaixo disso não compensa dividir
+
+    // Um canto de face: índices (base 0) de posição, UV e normal; -1 = ausente
+    struct Corner {
+        int64_t v, vt, vn;
+    };
+
+    // Bloco de linhas [begin, end) e o que ele contém
+    struct Chunk {
+        const char* begin;
+        const char* end;
+        uint32_t positions = 0, normals = 0, texcoords = 0, triangles = 0;
+        uint32_t positionBase = 0, normalBase = 0, texcoordBase = 0, triangleBase = 0;
+        bool valid = true;
+    };
+
+    inline bool isBlank(char c) {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    inline const char* skipBlanks(const char* p, const char* end) {
+        while (p < end && isBlank(*p)) p++;
+        return p;
+    }
+
+    inline const char* lineEnd(const char* p, const char* end) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        return nl ? nl : end;
+    }
+
+    // Próximo número do tipo T em [p, end); avança p. from_chars não aceita '+'.
+    template <typename T>
+    inline bool parseNumber(const char*& p, const char* end, T& value) {
+        p = skipBlanks(p, end);
+        if (p < end && *p == '+') p++;
+        auto result = std::from_chars(p, end, value);
+        if (result.ec != std::errc()) return false;
+        p = result.ptr;
+        return true;
+    }
+
+    // Tipo da linha a partir da palavra-chave; o conteúdo começa em 'rest'
+    enum class LineType { POSITION, NORMAL, TEXCOORD, FACE, OTHER };
+
+    inline LineType classify(const char* p, const char* end, const char*& rest) {
+        p = skipBlanks(p, end);
+        const char* word = p;
+        while (p < end && !isBlank(*p)) p++;
+        rest = p;
+        size_t length = p - word;
+        if (length == 1 && word[0] == 'v') return LineType::POSITION;
+        if (length == 1 && word[0] == 'f') return LineType::FACE;
+        if (length == 2 && word[0] == 'v' && word[1] == 'n') return LineType::NORMAL;
+        if (length == 2 && word[0] == 'v' && word[1] == 't') return LineType::TEXCOORD;
+        return LineType::OTHER;
+    }
+
+    // Número de vértices de uma face (tokens separados por espaço)
+    inline uint32_t countFaceVertices(const char* p, const char* end) {
+        uint32_t count = 0;
+        p = skipBlanks(p, end);
+        while (p < end) {
+            count++;
+            while (p < end && !isBlank(*p)) p++;
+            p = skipBlanks(p, end);
+        }
+        return count;
+    }
+
+    // Índice OBJ (base 1, negativo = relativo ao fim) para base 0
+    inline int64_t resolveIndex(int64_t index, uint32_t countSoFar) {
+        if (index > 0) return index - 1;
+        if (index < 0) return static_cast<int64_t>(countSoFar) + index;
+        return -1;
+    }
+
+    // Lê um canto "v", "v/vt", "v//vn" ou "v/vt/vn"
+    inline bool parseCorner(const char*& p, const char* end, const Chunk& chunk, uint32_t positions,
+                            uint32_t normals, uint32_t texcoords, Corner& corner) {
+        int64_t index;
+        if (!parseNumber(p, end, index)) return false;
+        corner.v = resolveIndex(index, chunk.positionBase + positions);
+        corner.vt = corner.vn = -1;
+        if (corner.v < 0) return false;
+
+        if (p < end && *p == '/') {
+            p++;
+            if (p < end && *p != '/') {
+                if (!parseNumber(p, end, index)) return false;
+                corner.vt = resolveIndex(index, chunk.texcoordBase + texcoords);
+            }
+            if (p < end && *p == '/') {
+                p++;
+                if (!parseNumber(p, end, index)) return false;
+                corner.vn = resolveIndex(index, chunk.normalBase + normals);
+            }
+        }
+        return true;
+    }
+
+    // Primeira passada: conta os elementos do bloco
+    void countChunk(Chunk& chunk) {
+        for (const char* line = chunk.begin; line < chunk.end;) {
+            const char* end = lineEnd(line, chunk.end);
+            const char* rest;
+            switch (classify(line, end, rest)) {
+                case LineType::POSITION: chunk.positions++; break;
+                case LineType::NORMAL:   chunk.normals++; break;
+                case LineType::TEXCOORD: chunk.texcoords++; break;
+                case LineType::FACE: {
+                    uint32_t n = countFaceVertices(rest, end);
+                    if (n >= 3) chunk.triangles += n - 2;
+                    break;
+                }
+                case LineType::OTHER: break;
+            }
+            line = end + 1;
+        }
+    }
+
+    // Segunda passada: escreve posições na malha e normais, UVs e cantos de
+    // triângulo nos buffers temporários, a partir das bases do bloco
+    void parseChunk(Chunk& chunk, Mesh& mesh, std::vector<float>& normals,
+                    std::vector<float>& texcoords, std::vector<Corner>& corners) {
+        uint32_t positionCount = 0, normalCount = 0, texcoordCount = 0, triangleCount = 0;
+
+        for (const char* line = chunk.begin; line < chunk.end;) {
+            const char* end = lineEnd(line, chunk.end);
+            const char* p;
+            switch (classify(line, end, p)) {
+                case LineType::POSITION: {
+                    float* out = &mesh.positions[3 * size_t(chunk.positionBase + positionCount++)];
+                    for (int k = 0; k < 3; k++) {
+                        if (!parseNumber(p, end, out[k])) chunk.valid = false;
+                    }
+                    break;
+                }
+                case LineType::NORMAL: {
+                    float* out = &normals[3 * size_t(chunk.normalBase + normalCount++)];
+                    for (int k = 0; k < 3; k++) {
+                        if (!parseNumber(p, end, out[k])) chunk.valid = false;
+                    }
+                    break;
+                }
+                case LineType::TEXCOORD: {
+                    // A segunda coordenada é opcional no formato
+                    float* out = &texcoords[2 * size_t(chunk.texcoordBase + texcoordCount++)];
+                    if (!parseNumber(p, end, out[0])) chunk.valid = false;
+                    if (!parseNumber(p, end, out[1])) out[1] = 0;
+                    break;
+                }
+                case LineType::FACE: {
+                    uint32_t n = countFaceVertices(p, end);
+                    if (n < 3) break;
+                    Corner first, previous, current;
+                    for (uint32_t k = 0; k < n; k++) {
+                        if (!parseCorner(p, end, chunk, positionCount, normalCount, texcoordCount, current)) {
+                            chunk.valid = false;
+                            current = Corner{0, -1, -1};
+                        }
+                        if (k == 0) {
+                            first = current;
+                        } else if (k >= 2) {
+                            Corner* out = &corners[3 * size_t(chunk.triangleBase + triangleCount++)];
+                            out[0] = first;
+                            out[1] = previous;
+                            out[2] = current;
+                        }
+                        previous = current;
+                    }
+                    break;
+                }
+                case LineType::OTHER: break;
+            }
+            line = end + 1;
+        }
+    }
+
+    struct CornerKey {
+        uint32_t v;
+        int64_t vt, vn;
+        bool operator==(const CornerKey& o) const { return v == o.v && vt == o.vt && vn == o.vn; }
+    };
+
+    struct CornerKeyHash {
+        size_t operator()(const CornerKey& k) const {
+            return std::hash<uint64_t>()((uint64_t(k.v) * 0x9E3779B97F4A7C15ull) ^
+                                         (uint64_t(k.vt) << 32) ^ uint64_t(k.vn));
+        }
+    };
+}
+
+std::shared_ptr<Mesh> loadOBJ(const std::string& filename, const Material& material, ThreadPool* pool) {
+    MappedFile file;
+    if (!file.open(filename)) return nullptr;
+
+    std::unique_ptr<ThreadPool> ownPool;
+    if (!pool) {
+        ownPool = std::make_unique<ThreadPool>();
+        pool = ownPool.get();
+    }
+
+    // Blocos terminam sempre numa quebra de linha
+    const char* data = file.data();
+    const char* dataEnd = data + file.size();
+    size_t chunkCount = std::max<size_t>(1, std::min<size_t>(pool->size() * 4, file.size() / MIN_CHUNK_BYTES));
+    std::vector<Chunk> chunks;
+    const char* begin = data;
+    for (size_t c = 1; c <= chunkCount && begin < dataEnd; c++) {
+        const char* end = (c == chunkCount) ? dataEnd : std::max(begin, data + file.size() * c / chunkCount);
+        end = (end < dataEnd) ? lineEnd(end, dataEnd) : dataEnd;
+        if (end < dataEnd) end++;
+        Chunk chunk;
+        chunk.begin = begin;
+        chunk.end = end;
+        chunks.push_back(chunk);
+        begin = end;
+    }
+
+    pool->parallelFor(static_cast<int>(chunks.size()), [&](int c) {
+        countChunk(chunks[c]);
+    });
+
+    // Bases de cada bloco: a numeração do OBJ segue a ordem do arquivo
+    uint64_t positions = 0, normalTotal = 0, texcoordTotal = 0, triangles = 0;
+    for (auto& chunk : chunks) {
+        chunk.positionBase = static_cast<uint32_t>(positions);
+        chunk.normalBase = static_cast<uint32_t>(normalTotal);
+        chunk.texcoordBase = static_cast<uint32_t>(texcoordTotal);
+        chunk.triangleBase = static_cast<uint32_t>(triangles);
+        positions += chunk.positions;
+        normalTotal += chunk.normals;
+        texcoordTotal += chunk.texcoords;
+        triangles += chunk.triangles;
+    }
+    if (positions >= UINT32_MAX || triangles >= UINT32_MAX / 3) {
+        std::cerr << "Erro: malha grande demais para índices de 32 bits: " << filename << std::endl;
+        return nullptr;
+    }
+    if (triangles == 0) {
+        std::cerr << "Erro: OBJ sem faces: " << filename << std::endl;
+        return nullptr;
+    }
+
+    auto mesh = std::make_shared<Mesh>(material, filename);
+    std::vector<float> normals(3 * normalTotal);
+    std::vector<float> texcoords(2 * texcoordTotal);
+    std::vector<Corner> corners(3 * triangles);
+    mesh->positions.resize(3 * positions);
+
+    pool->parallelFor(static_cast<int>(chunks.size()), [&](int c) {
+        parseChunk(chunks[c], *mesh, normals, texcoords, corners);
+    });
+
+    for (const auto& chunk : chunks) {
+        if (!chunk.valid) {
+            std::cerr << "Erro: OBJ com números ou faces inválidos: " << filename << std::endl;
+            return nullptr;
+        }
+    }
+
+    // Um índice por vértice: o canto usa o vértice da sua posição se ela
+    // ainda não tem normal/UV ou tem as mesmas; senão, um vértice duplicado
+    bool hasNormals = normalTotal > 0;
+    bool hasTexcoords = texcoordTotal > 0;
+    if (hasNormals) mesh->normals.assign(3 * positions, 0.0f);
+    if (hasTexcoords) mesh->texcoords.assign(2 * positions, 0.0f);
+
+    const int64_t UNUSED = -2;
+    std::vector<int64_t> usedVt(positions, UNUSED), usedVn(positions, UNUSED);
+    std::unordered_map<CornerKey, uint32_t, CornerKeyHash> duplicates;
+    mesh->indices.resize(3 * triangles);
+
+    for (size_t i = 0; i < corners.size(); i++) {
+        const Corner& c = corners[i];
+        if (c.v >= static_cast<int64_t>(positions) || c.vt >= static_cast<int64_t>(texcoordTotal) ||
+            c.vn >= static_cast<int64_t>(normalTotal) || c.vt < -1 || c.vn < -1) {
+            std::cerr << "Erro: OBJ com índice fora do intervalo: " << filename << std::endl;
+            return nullptr;
+        }
+
+        uint32_t vertex = static_cast<uint32_t>(c.v);
+        if (usedVt[vertex] == UNUSED) {
+            usedVt[vertex] = c.vt;
+            usedVn[vertex] = c.vn;
+        } else if (usedVt[vertex] != c.vt || usedVn[vertex] != c.vn) {
+            CornerKey key{vertex, c.vt, c.vn};
+            auto found = duplicates.find(key);
+            if (found != duplicates.end()) {
+                mesh->indices[i] = found->second;
+                continue;
+            }
+            uint32_t copy = mesh->vertexCount();
+            mesh->addVertex(mesh->vertex(vertex));
+            if (hasNormals) mesh->normals.resize(mesh->normals.size() + 3, 0.0f);
+            if (hasTexcoords) mesh->texcoords.resize(mesh->texcoords.size() + 2, 0.0f);
+            duplicates.emplace(key, copy);
+            vertex = copy;
+        } else {
+            mesh->indices[i] = vertex;
+            continue;
+        }
+
+        // Primeiro uso deste vértice: copia os atributos do canto
+        if (hasNormals && c.vn >= 0) {
+            std::copy(&normals[3 * c.vn], &normals[3 * c.vn] + 3, &mesh->normals[3 * size_t(vertex)]);
+        }
+        if (hasTexcoords && c.vt >= 0) {
+            std::copy(&texcoords[2 * c.vt], &texcoords[2 * c.vt] + 2, &mesh->texcoords[2 * size_t(vertex)]);
+        }
+        mesh->indices[i] = vertex;
+    }
+
+    mesh->buildBVH();
+    return mesh;
+}
+
+// ============ CACHE BINÁRIO ============
+
+namespace {
+    const char MESH_CACHE_MAGIC[8] = {'C', 'G', 'M', 'E', 'S', 'H', '\0', '\0'};
+    const uint64_t SECTION_ALIGNMENT = 64;
+
+    enum Section {
+        SECTION_POSITIONS, SECTION_NORMALS, SECTION_TEXCOORDS, SECTION_INDICES,
+        SECTION_FACE_MATERIALS, SECTION_MATERIALS, SECTION_BVH_NODES, SECTION_BVH_INDICES,
+        SECTION_NAME, SECTION_COUNT
+    };
+
+    struct SectionRange {
+        uint64_t offset;  // Em bytes, desde o início do arquivo
+        uint64_t count;   // Em elementos
+    };
+
+    struct MeshCacheHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t realSize;      // sizeof(Real) da compilação que gravou
+        uint32_t nodeSize;      // sizeof(BVHNode)
+        uint32_t reserved;
+        uint64_t sourceSize;    // Tamanho e data do OBJ de origem (0 se não houver)
+        int64_t sourceTime;
+        SectionRange sections[SECTION_COUNT];
+    };
+
+    // Material sem o ponteiro de função, em double independente de Real
+    struct MaterialRecord {
+        double ka[3], kd[3], ks[3];
+        double shininess;
+    };
+
+    static_assert(std::is_trivially_copyable<BVHNode>::value, "BVHNode é gravado byte a byte");
+
+    MaterialRecord toRecord(const Material& m) {
+        return MaterialRecord{{m.ka.r, m.ka.g, m.ka.b}, {m.kd.r, m.kd.g, m.kd.b},
+                              {m.ks.r, m.ks.g, m.ks.b}, m.shininess};
+    }
+
+    Material fromRecord(const MaterialRecord& r) {
+        return Material(Color(r.ka[0], r.ka[1], r.ka[2]), Color(r.kd[0], r.kd[1], r.kd[2]),
+                        Color(r.ks[0], r.ks[1], r.ks[2]), r.shininess);
+    }
+
+    bool writeMeshCache(const std::string& filename, const Mesh& mesh, uint64_t sourceSize, int64_t sourceTime) {
+        if (!mesh.hasBVH()) {
+            std::cerr << "Erro: malha sem BVH não pode ir para o cache: " << mesh.name << std::endl;
+            return false;
+        }
+
+        std::vector<MaterialRecord> materials;
+        materials.push_back(toRecord(mesh.material));
+        for (const auto& m : mesh.materials) {
+            materials.push_back(toRecord(m));
+        }
+        const BVH& bvh = mesh.getBVH();
+
+        struct Block {
+            const void* data;
+            uint64_t count;
+            uint64_t elementSize;
+        };
+        Block blocks[SECTION_COUNT] = {
+            {mesh.positions.data(), mesh.positions.size(), sizeof(float)},
+            {mesh.normals.data(), mesh.normals.size(), sizeof(float)},
+            {mesh.texcoords.data(), mesh.texcoords.size(), sizeof(float)},
+            {mesh.indices.data(), mesh.indices.size(), sizeof(uint32_t)},
+            {mesh.faceMaterials.data(), mesh.faceMaterials.size(), sizeof(uint32_t)},
+            {materials.data(), materials.size(), sizeof(MaterialRecord)},
+            {bvh.nodes.data(), bvh.nodes.size(), sizeof(BVHNode)},
+            {bvh.indices.data(), bvh.indices.size(), sizeof(uint32_t)},
+            {mesh.name.data(), mesh.name.size(), 1},
+        };
+
+        MeshCacheHeader header = {};
+        std::memcpy(header.magic, MESH_CACHE_MAGIC, sizeof(header.magic));
+        header.version = MESH_CACHE_VERSION;
+        header.realSize = sizeof(Real);
+        header.nodeSize = sizeof(BVHNode);
+        header.sourceSize = sourceSize;
+        header.sourceTime = sourceTime;
+
+        uint64_t offset = sizeof(MeshCacheHeader);
+        for (int s = 0; s < SECTION_COUNT; s++) {
+            offset = (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+            header.sections[s] = SectionRange{offset, blocks[s].count};
+            offset += blocks[s].count * blocks[s].elementSize;
+        }
+
+        // Grava num temporário e renomeia: um leitor nunca vê um cache pela metade
+        std::string tempName = filename + ".tmp";
+        std::ofstream file(tempName, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Erro ao abrir arquivo: " << tempName << std::endl;
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        uint64_t position = sizeof(header);
+        const char padding[SECTION_ALIGNMENT] = {};
+        for (int s = 0; s < SECTION_COUNT; s++) {
+            file.write(padding, header.sections[s].offset - position);
+            uint64_t bytes = blocks[s].count * blocks[s].elementSize;
+            if (bytes > 0) {
+                file.write(static_cast<const char*>(blocks[s].data), bytes);
+            }
+            position = header.sections[s].offset + bytes;
+        }
+        file.close();
+        if (!file || std::rename(tempName.c_str(), filename.c_str()) != 0) {
+            std::cerr << "Erro ao gravar cache de malha: " << filename << std::endl;
+            std::remove(tempName.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    // Cabeçalho válido para esta compilação e seções dentro do arquivo?
+    const MeshCacheHeader* checkHeader(const MappedFile& file) {
+        if (file.size() < sizeof(MeshCacheHeader)) return nullptr;
+        const MeshCacheHeader* header = reinterpret_cast<const MeshCacheHeader*>(file.data());
+        if (std::memcmp(header->magic, MESH_CACHE_MAGIC, sizeof(header->magic)) != 0 ||
+            header->version != MESH_CACHE_VERSION || header->realSize != sizeof(Real) ||
+            header->nodeSize != sizeof(BVHNode)) {
+            return nullptr;
+        }
+
+        const uint64_t elementSizes[SECTION_COUNT] = {
+            sizeof(float), sizeof(float), sizeof(float), sizeof(uint32_t), sizeof(uint32_t),
+            sizeof(MaterialRecord), sizeof(BVHNode), sizeof(uint32_t), 1
+        };
+        for (int s = 0; s < SECTION_COUNT; s++) {
+            const SectionRange& range = header->sections[s];
+            // copySection reinterpreta a seção no lugar: o deslocamento tem que
+            // manter o alinhamento com que o cache foi gravado
+            if (range.offset % SECTION_ALIGNMENT != 0 || range.offset > file.size() ||
+                range.count > (file.size() - range.offset) / elementSizes[s]) {
+                return nullptr;
+            }
+        }
+        return header;
+    }
+
+    template <typename T>
+    void copySection(const MappedFile& file, const SectionRange& range, std::vector<T>& out) {
+        const T* begin = reinterpret_cast<const T*>(file.data() + range.offset);
+        out.assign(begin, begin + range.count);
+    }
+}
+
+bool saveMeshCache(const std::string& filename, const Mesh& mesh) {
+    return writeMeshCache(filename, mesh, 0, 0);
+}
+
+// Monta a malha a partir de um cache já mapeado e com cabeçalho válido
+static std::shared_ptr<Mesh> readMeshCache(const MappedFile& file, const MeshCacheHeader* header,
+                                           const std::string& filename) {
+    const SectionRange* sections = header->sections;
+    std::vector<MaterialRecord> materials;
+    copySection(file, sections[SECTION_MATERIALS], materials);
+    if (materials.empty()) {
+        std::cerr << "Erro: cache de malha sem material: " << filename << std::endl;
+        return nullptr;
+    }
+
+    auto mesh = std::make_shared<Mesh>(fromRecord(materials[0]),
+        std::string(file.data() + sections[SECTION_NAME].offset, sections[SECTION_NAME].count));
+    for (size_t m = 1; m < materials.size(); m++) {
+        mesh->materials.push_back(fromRecord(materials[m]));
+    }
+    copySection(file, sections[SECTION_POSITIONS], mesh->positions);
+    copySection(file, sections[SECTION_NORMALS], mesh->normals);
+    copySection(file, sections[SECTION_TEXCOORDS], mesh->texcoords);
+    copySection(file, sections[SECTION_INDICES], mesh->indices);
+    copySection(file, sections[SECTION_FACE_MATERIALS], mesh->faceMaterials);
+
+    BVH bvh;
+    copySection(file, sections[SECTION_BVH_NODES], bvh.nodes);
+    copySection(file, sections[SECTION_BVH_INDICES], bvh.indices);
+
+    // Referências fora dos buffers tornariam a travessia insegura
+    uint32_t vertices = mesh->vertexCount();
+    uint32_t triangles = mesh->triangleCount();
+    bool consistent = bvh.indices.size() == triangles &&
+                      (mesh->faceMaterials.empty() || mesh->faceMaterials.size() == triangles);
+    for (size_t i = 0; consistent && i < mesh->indices.size(); i++) {
+        consistent = mesh->indices[i] < vertices;
+    }
+    for (size_t i = 0; consistent && i < bvh.indices.size(); i++) {
+        consistent = bvh.indices[i] < triangles;
+    }
+    for (size_t i = 0; consistent && i < mesh->faceMaterials.size(); i++) {
+        consistent = mesh->faceMaterials[i] <= mesh->materials.size();
+    }
+    // A árvore vem do arquivo: filhos sempre depois do pai (sem ciclos) e
+    // profundidade dentro da pilha das travessias. Sem nós, a malha nunca
+    // seria atingida.
+    consistent = consistent && (triangles == 0 || !bvh.nodes.empty());
+    std::vector<int> depth(bvh.nodes.size(), 0);
+    for (size_t i = 0; consistent && i < bvh.nodes.size(); i++) {
+        const BVHNode& node = bvh.nodes[i];
+        if (node.isLeaf()) {
+            consistent = uint64_t(node.leftFirst) + node.count <= triangles;
+            continue;
+        }
+        consistent = node.leftFirst > i && uint64_t(node.leftFirst) + 1 < bvh.nodes.size() &&
+                     depth[i] < BVH::MAX_DEPTH;
+        if (consistent) {
+            for (uint32_t child = node.leftFirst; child <= node.leftFirst + 1; child++) {
+                depth[child] = std::max(depth[child], depth[i] + 1);
+            }
+        }
+    }
+    if (!consistent) {
+        std::cerr << "Erro: cache de malha corrompido: " << filename << std::endl;
+        return nullptr;
+    }
+
+    mesh->setBVH(std::move(bvh));
+    return mesh;
+}
+
+std::shared_ptr<Mesh> loadMeshCache(const std::string& filename) {
+    MappedFile file;
+    if (!file.open(filename)) return nullptr;
+
+    const MeshCacheHeader* header = checkHeader(file);
+    if (!header) {
+        std::cerr << "Erro: cache de malha inválido ou de outra versão: " << filename << std::endl;
+        return nullptr;
+    }
+    return readMeshCache(file, header, filename);
+}
+
+std::shared_ptr<Mesh> loadOBJCached(const std::string& objFilename, const Material& material,
+                                    ThreadPool* pool, const std::string& cacheFilename) {
+    std::string cacheName = cacheFilename.empty() ? objFilename + ".cache" : cacheFilename;
+
+    uint64_t sourceSize;
+    int64_t sourceTime;
+    if (!fileStamp(objFilename, sourceSize, sourceTime)) {
+        std::cerr << "Erro ao abrir arquivo: " << objFilename << std::endl;
+        return nullptr;
+    }
+
+    // Cache gerado a partir deste mesmo OBJ? (sem cache, sem mensagem de erro)
+    uint64_t cacheSize;
+    int64_t cacheTime;
+    MappedFile cache;
+    if (fileStamp(cacheName, cacheSize, cacheTime) && cache.open(cacheName)) {
+        const MeshCacheHeader* header = checkHeader(cache);
+        if (header && header->sourceSize == sourceSize && header->sourceTime == sourceTime) {
+            auto mesh = readMeshCache(cache, header, cacheName);
+            if (mesh) {
+                mesh->material = material;
+                return mesh;
+            }
+        }
+        cache.close();
+    }
+
+    auto mesh = loadOBJ(objFilename, material, pool);
+    if (mesh) {
+        writeMeshCache(cacheName, *mesh, sourceSize, sourceTime);
+    }
+    return mesh;
+}
@@ -1,27 +1,57 @@
 #include "../include/Objects.h"
 #include <cmath>
+#include <algorithm>
+#include <cstring>
 
-const double EPSILON = 1e-6;
+const Real EPSILON = 1e-6;
+
+// ============ PACOTES DE RAIOS ============
+// Os intersectores de pacote repetem as contas da versão escalar (mesma
+// ordem de operações) sobre registradores SimdReal, sem desvios: para cada
+// bloco c de SIMD_WIDTH raios calculam a máscara dos que acertam antes de
+// hit.t[c] e gravam só esses.
+
+static inline void commitPacket(int c, SimdMask accept, SimdReal t, PacketHit& hit,
+                                const Object* object, uint32_t primId) {
+    hit.t[c] = accept ? t : hit.t[c];
+    for (int k = 0; k < SIMD_WIDTH; k++) {
+        if (accept[k]) {
+            hit.object[c * SIMD_WIDTH + k] = object;
+            hit.primId[c * SIMD_WIDTH + k] = primId;
+        }
+    }
+}
+
+void Object::intersect(const RayPacket& packet, PacketHit& hit) const {
+    for (int k = 0; k < PACKET_SIZE; k++) {
+        Real tMax = packetLane(hit.t, k);
+        if (tMax < 0) continue;
+        HitRecord rec;
+        if (intersect(packet.get(k), tMax, rec)) {
+            hit.set(k, rec);
+        }
+    }
+}
 
 // SPHERE INTERSECTION
-bool Sphere::intersect(const Ray& ray, HitRecord& rec) const {
+bool Sphere::intersect(const Ray& ray, double tMax, HitRecord& rec) const {
     Vector3 oc = ray.origin - center;
     
-    double a = ray.direction.dot(ray.direction);
-    double b = 2.0 * oc.dot(ray.direction);
-    double c = oc.dot(oc) - radius * radius;
+    Real a = ray.direction.dot(ray.direction);
+    Real b = 2 * oc.dot(ray.direction);
+    Real c = oc.dot(oc) - radius * radius;
     
-    double discriminant = b * b - 4 * a * c;
+    Real discriminant = b * b - 4 * a * c;
     
     if (discriminant < 0) {
         return false;
     }
     
-    double sqrtDisc = std::sqrt(discriminant);
-    double t1 = (-b - sqrtDisc) / (2 * a);
-    double t2 = (-b + sqrtDisc) / (2 * a);
+    Real sqrtDisc = std::sqrt(discriminant);
+    Real t1 = (-b - sqrtDisc) / (2 * a);
+    Real t2 = (-b + sqrtDisc) / (2 * a);
     
-    double t = -1;
+    Real t = -1;
     if (t1 > EPSILON) {
         t = t1;
     } else if (t2 > EPSILON) {
@@ -29,75 +59,118 @@ bool Sphere::intersect(const Ray& ray, HitRecord& rec) const {
     } else {
         return false;
     }
+
+    if (t >= tMax) {
+        return false;
+    }
     
     rec.t = t;
-    rec.point = ray.at(t);
-    rec.normal = (rec.point - center).normalized();
-    rec.material = material;
     rec.object = this;
+    rec.primId = 0;
 
     return true;
 }
 
+void Sphere::computeSurface(const Ray& ray, const HitRecord& rec, SurfaceRecord& surface) const {
+    surface.point = ray.at(rec.t);
+    surface.normal = (surface.point - center).normalized();
+    surface.material = &material;
+}
+
+void Sphere::intersect(const RayPacket& packet, PacketHit& hit) const {
+    for (int c = 0; c < PACKET_CHUNKS; c++) {
+        SimdReal ocx = packet.ox[c] - center.x;
+        SimdReal ocy = packet.oy[c] - center.y;
+        SimdReal ocz = packet.oz[c] - center.z;
+
+        SimdReal a = packet.dx[c] * packet.dx[c] + packet.dy[c] * packet.dy[c] + packet.dz[c] * packet.dz[c];
+        SimdReal b = 2 * (ocx * packet.dx[c] + ocy * packet.dy[c] + ocz * packet.dz[c]);
+        SimdReal cc = (ocx * ocx + ocy * ocy + ocz * ocz) - static_cast<Real>(radius * radius);
+
+        SimdReal discriminant = b * b - 4 * a * cc;
+        SimdMask real = discriminant >= 0;
+        SimdReal sqrtDisc = simdSqrt(real ? discriminant : 0);
+        SimdReal t1 = (-b - sqrtDisc) / (2 * a);
+        SimdReal t2 = (-b + sqrtDisc) / (2 * a);
+        SimdReal t = t1 > EPSILON ? t1 : t2;
+
+        commitPacket(c, real & (t > EPSILON) & (t < hit.t[c]), t, hit, this, 0);
+    }
+}
+
 // PLANE INTERSECTION
-bool Plane::intersect(const Ray& ray, HitRecord& rec) const {
-    double denom = normal.dot(ray.direction);
+bool Plane::intersect(const Ray& ray, double tMax, HitRecord& rec) const {
+    Real denom = normal.dot(ray.direction);
 
     if (std::abs(denom) < EPSILON) {
         return false;
     }
 
-    double t = (point - ray.origin).dot(normal) / denom;
+    Real t = (point - ray.origin).dot(normal) / denom;
 
-    if (t < EPSILON) {
+    if (t < EPSILON || t >= tMax) {
         return false;
     }
 
     rec.t = t;
-    rec.point = ray.at(t);
-    rec.normal = normal;
-    rec.material = material;
     rec.object = this;
+    rec.primId = 0;
 
     return true;
 }
 
+void Plane::computeSurface(const Ray& ray, const HitRecord& rec, SurfaceRecord& surface) const {
+    surface.point = ray.at(rec.t);
+    surface.normal = normal;
+    surface.material = &material;
+}
+
+void Plane::intersect(const RayPacket& packet, PacketHit& hit) const {
+    for (int c = 0; c < PACKET_CHUNKS; c++) {
+        SimdReal denom = normal.x * packet.dx[c] + normal.y * packet.dy[c] + normal.z * packet.dz[c];
+        SimdReal t = ((point.x - packet.ox[c]) * normal.x + (point.y - packet.oy[c]) * normal.y +
+                      (point.z - packet.oz[c]) * normal.z) / denom;
+
+        // |denom| >= EPSILON
+        SimdMask facing = (denom >= EPSILON) | (denom <= -EPSILON);
+        commitPacket(c, facing & (t >= EPSILON) & (t < hit.t[c]), t, hit, this, 0);
+    }
+}
+
 // CYLINDER INTERSECTION
-bool Cylinder::intersect(const Ray& ray, HitRecord& rec) const {
+bool Cylinder::intersect(const Ray& ray, double tMax, HitRecord& rec) const {
     Vector3 oc = ray.origin - baseCenter;
     
     // Componentes perpendiculares ao eixo
     Vector3 dPerp = ray.direction - axis * ray.direction.dot(axis);
     Vector3 ocPerp = oc - axis * oc.dot(axis);
     
-    double a = dPerp.dot(dPerp);
-    double b = 2.0 * ocPerp.dot(dPerp);
-    double c = ocPerp.dot(ocPerp) - radius * radius;
+    Real a = dPerp.dot(dPerp);
+    Real b = 2 * ocPerp.dot(dPerp);
+    Real c = ocPerp.dot(ocPerp) - radius * radius;
     
-    double discriminant = b * b - 4 * a * c;
+    Real discriminant = b * b - 4 * a * c;
     
     if (discriminant < 0) {
         return false;
     }
     
-    double sqrtDisc = std::sqrt(discriminant);
-    double t1 = (-b - sqrtDisc) / (2 * a);
-    double t2 = (-b + sqrtDisc) / (2 * a);
+    Real sqrtDisc = std::sqrt(discriminant);
+    Real t1 = (-b - sqrtDisc) / (2 * a);
+    Real t2 = (-b + sqrtDisc) / (2 * a);
     
     // Verifica ambas as soluções
-    for (double t : {t1, t2}) {
+    for (Real t : {t1, t2}) {
         if (t < EPSILON) continue;
         
         Vector3 point = ray.at(t);
-        double projOnAxis = (point - baseCenter).dot(axis);
+        Real projOnAxis = (point - baseCenter).dot(axis);
         
         if (projOnAxis >= 0 && projOnAxis <= height) {
+            if (t >= tMax) return false;
             rec.t = t;
-            rec.point = point;
-            Vector3 pointOnAxis = baseCenter + axis * projOnAxis;
-            rec.normal = (point - pointOnAxis).normalized();
-            rec.material = material;
             rec.object = this;
+            rec.primId = 0;
             return true;
         }
     }
@@ -105,45 +178,94 @@ bool Cylinder::intersect(const Ray& ray, HitRecord& rec) const {
     return false;
 }
 
+void Cylinder::computeSurface(const Ray& ray, const HitRecord& rec, SurfaceRecord& surface) const {
+    surface.point = ray.at(rec.t);
+    Real projOnAxis = (surface.point - baseCenter).dot(axis);
+    Vector3 pointOnAxis = baseCenter + axis * projOnAxis;
+    surface.normal = (surface.point - pointOnAxis).normalized();
+    surface.material = &material;
+}
+
+// Máscara das raízes t (bloco c) à frente do raio e com o ponto dentro da altura [0, height] do eixo
+static inline SimdMask withinAxis(const RayPacket& packet, int c, SimdReal t, const Vector3& base,
+                                  const Vector3& axis, double height) {
+    SimdReal px = packet.ox[c] + packet.dx[c] * t;
+    SimdReal py = packet.oy[c] + packet.dy[c] * t;
+    SimdReal pz = packet.oz[c] + packet.dz[c] * t;
+    SimdReal projOnAxis = (px - base.x) * axis.x + (py - base.y) * axis.y + (pz - base.z) * axis.z;
+    return (t >= EPSILON) & (projOnAxis >= 0) & (projOnAxis <= static_cast<Real>(height));
+}
+
+void Cylinder::intersect(const RayPacket& packet, PacketHit& hit) const {
+    for (int c = 0; c < PACKET_CHUNKS; c++) {
+        SimdReal ocx = packet.ox[c] - baseCenter.x;
+        SimdReal ocy = packet.oy[c] - baseCenter.y;
+        SimdReal ocz = packet.oz[c] - baseCenter.z;
+
+        // Componentes perpendiculares ao eixo
+        SimdReal dDotAxis = packet.dx[c] * axis.x + packet.dy[c] * axis.y + packet.dz[c] * axis.z;
+        SimdReal dPerpX = packet.dx[c] - axis.x * dDotAxis;
+        SimdReal dPerpY = packet.dy[c] - axis.y * dDotAxis;
+        SimdReal dPerpZ = packet.dz[c] - axis.z * dDotAxis;
+        SimdReal ocDotAxis = ocx * axis.x + ocy * axis.y + ocz * axis.z;
+        SimdReal ocPerpX = ocx - axis.x * ocDotAxis;
+        SimdReal ocPerpY = ocy - axis.y * ocDotAxis;
+        SimdReal ocPerpZ = ocz - axis.z * ocDotAxis;
+
+        SimdReal a = dPerpX * dPerpX + dPerpY * dPerpY + dPerpZ * dPerpZ;
+        SimdReal b = 2 * (ocPerpX * dPerpX + ocPerpY * dPerpY + ocPerpZ * dPerpZ);
+        SimdReal cc = (ocPerpX * ocPerpX + ocPerpY * ocPerpY + ocPerpZ * ocPerpZ) -
+                      static_cast<Real>(radius * radius);
+
+        SimdReal discriminant = b * b - 4 * a * cc;
+        SimdMask real = discriminant >= 0;
+        SimdReal sqrtDisc = simdSqrt(real ? discriminant : 0);
+        SimdReal t1 = (-b - sqrtDisc) / (2 * a);
+        SimdReal t2 = (-b + sqrtDisc) / (2 * a);
+
+        // Primeira raiz com o ponto dentro da altura
+        SimdMask in1 = withinAxis(packet, c, t1, baseCenter, axis, height);
+        SimdMask in2 = withinAxis(packet, c, t2, baseCenter, axis, height);
+        SimdReal t = in1 ? t1 : t2;
+
+        commitPacket(c, real & (in1 | in2) & (t < hit.t[c]), t, hit, this, 0);
+    }
+}
+
 // CONE INTERSECTION
-bool Cone::intersect(const Ray& ray, HitRecord& rec) const {
-    double cosAlphaSq = (height * height) / (height * height + radius * radius);
+bool Cone::intersect(const Ray& ray, double tMax, HitRecord& rec) const {
+    Real cosAlphaSq = (height * height) / (height * height + radius * radius);
     
     Vector3 oc = ray.origin - baseCenter;
     
-    double dDotV = ray.direction.dot(axis);
-    double ocDotV = oc.dot(axis);
+    Real dDotV = ray.direction.dot(axis);
+    Real ocDotV = oc.dot(axis);
     
-    double a = dDotV * dDotV - cosAlphaSq;
-    double b = 2 * (dDotV * ocDotV - ray.direction.dot(oc) * cosAlphaSq);
-    double c = ocDotV * ocDotV - oc.dot(oc) * cosAlphaSq;
+    Real a = dDotV * dDotV - cosAlphaSq;
+    Real b = 2 * (dDotV * ocDotV - ray.direction.dot(oc) * cosAlphaSq);
+    Real c = ocDotV * ocDotV - oc.dot(oc) * cosAlphaSq;
     
-    double discriminant = b * b - 4 * a * c;
+    Real discriminant = b * b - 4 * a * c;
     
     if (discriminant < 0) {
         return false;
     }
     
-    double sqrtDisc = std::sqrt(discriminant);
-    double t1 = (-b - sqrtDisc) / (2 * a);
-    double t2 = (-b + sqrtDisc) / (2 * a);
+    Real sqrtDisc = std::sqrt(discriminant);
+    Real t1 = (-b - sqrtDisc) / (2 * a);
+    Real t2 = (-b + sqrtDisc) / (2 * a);
     
-    for (double t : {t1, t2}) {
+    for (Real t : {t1, t2}) {
         if (t < EPSILON) continue;
         
         Vector3 point = ray.at(t);
-        double projOnAxis = (point - baseCenter).dot(axis);
+        Real projOnAxis = (point - baseCenter).dot(axis);
         
         if (projOnAxis >= 0 && projOnAxis <= height) {
+            if (t >= tMax) return false;
             rec.t = t;
-            rec.point = point;
-
-            Vector3 pointOnAxis = baseCenter + axis * projOnAxis;
-            Vector3 radial = (point - pointOnAxis).normalized();
-            Vector3 tangent = axis;
-            rec.normal = (radial - tangent * (radius / height)).normalized();
-            rec.material = material;
             rec.object = this;
+            rec.primId = 0;
             return true;
         }
     }
@@ -151,61 +273,469 @@ bool Cone::intersect(const Ray& ray, HitRecord& rec) const {
     return false;
 }
 
+void Cone::computeSurface(const Ray& ray, const HitRecord& rec, SurfaceRecord& surface) const {
+    surface.point = ray.at(rec.t);
+
+    Real projOnAxis = (surface.point - baseCenter).dot(axis);
+    Vector3 pointOnAxis = baseCenter + axis * projOnAxis;
+    Vector3 radial = (surface.point - pointOnAxis).normalized();
+    Vector3 tangent = axis;
+    surface.normal = (radial - tangent * (radius / height)).normalized();
+    surface.material = &material;
+}
+
+void Cone::intersect(const RayPacket& packet, PacketHit& hit) const {
+    Real cosAlphaSq = (height * height) / (height * height + radius * radius);
+
+    for (int c = 0; c < PACKET_CHUNKS; c++) {
+        SimdReal ocx = packet.ox[c] - baseCenter.x;
+        SimdReal ocy = packet.oy[c] - baseCenter.y;
+        SimdReal ocz = packet.oz[c] - baseCenter.z;
+
+        SimdReal dDotV = packet.dx[c] * axis.x + packet.dy[c] * axis.y + packet.dz[c] * axis.z;
+        SimdReal ocDotV = ocx * axis.x + ocy * axis.y + ocz * axis.z;
+        SimdReal dDotOc = packet.dx[c] * ocx + packet.dy[c] * ocy + packet.dz[c] * ocz;
+        SimdReal ocDotOc = ocx * ocx + ocy * ocy + ocz * ocz;
+
+        SimdReal a = dDotV * dDotV - cosAlphaSq;
+        SimdReal b = 2 * (dDotV * ocDotV - dDotOc * cosAlphaSq);
+        SimdReal cc = ocDotV * ocDotV - ocDotOc * cosAlphaSq;
+
+        SimdReal discriminant = b * b - 4 * a * cc;
+        SimdMask real = discriminant >= 0;
+        SimdReal sqrtDisc = simdSqrt(real ? discriminant : 0);
+        SimdReal t1 = (-b - sqrtDisc) / (2 * a);
+        SimdReal t2 = (-b + sqrtDisc) / (2 * a);
+
+        SimdMask in1 = withinAxis(packet, c, t1, baseCenter, axis, height);
+        SimdMask in2 = withinAxis(packet, c, t2, baseCenter, axis, height);
+        SimdReal t = in1 ? t1 : t2;
+
+        commitPacket(c, real & (in1 | in2) & (t < hit.t[c]), t, hit, this, 0);
+    }
+}
+
 // TRIANGLE INTERSECTION (Möller-Trumbore algorithm)
-bool Triangle::intersect(const Ray& ray, HitRecord& rec) const {
-    Vector3 edge1 = v1 - v0;
-    Vector3 edge2 = v2 - v0;
+// Compartilhado por Triangle e Mesh, com as arestas já calculadas:
+// preenche só rec.t e rec.u/v
+static bool intersectTriangle(const Ray& ray, const Vector3& v0, const Vector3& edge1, const Vector3& edge2,
+                              double tMax, HitRecord& rec) {
     Vector3 h = ray.direction.cross(edge2);
-    double a = edge1.dot(h);
+    Real a = edge1.dot(h);
     
     if (std::abs(a) < EPSILON) {
         return false;
     }
     
-    double f = 1.0 / a;
+    Real f = 1 / a;
     Vector3 s = ray.origin - v0;
-    double u = f * s.dot(h);
+    Real u = f * s.dot(h);
     
     if (u < 0.0 || u > 1.0) {
         return false;
     }
     
     Vector3 q = s.cross(edge1);
-    double v = f * ray.direction.dot(q);
+    Real v = f * ray.direction.dot(q);
     
     if (v < 0.0 || u + v > 1.0) {
         return false;
     }
     
-    double t = f * edge2.dot(q);
+    Real t = f * edge2.dot(q);
     
-    if (t < EPSILON) {
+    if (t < EPSILON || t >= tMax) {
         return false;
     }
     
     rec.t = t;
-    rec.point = ray.at(t);
-    rec.normal = normal;
-    rec.material = material;
-    rec.object = this;
+    rec.u = static_cast<float>(u);
+    rec.v = static_cast<float>(v);
 
     return true;
 }
 
+// Versão de pacote, registrando o acerto em nome de owner com o índice primId
+static void intersectTriangle(const RayPacket& packet, PacketHit& hit,
+                              const Vector3& v0, const Vector3& edge1, const Vector3& edge2,
+                              const Object* owner, uint32_t primId) {
+    for (int c = 0; c < PACKET_CHUNKS; c++) {
+        // h = direção x edge2
+        SimdReal hx = packet.dy[c] * edge2.z - packet.dz[c] * edge2.y;
+        SimdReal hy = packet.dz[c] * edge2.x - packet.dx[c] * edge2.z;
+        SimdReal hz = packet.dx[c] * edge2.y - packet.dy[c] * edge2.x;
+        SimdReal a = edge1.x * hx + edge1.y * hy + edge1.z * hz;
+
+        SimdReal f = 1 / a;
+        SimdReal sx = packet.ox[c] - v0.x;
+        SimdReal sy = packet.oy[c] - v0.y;
+        SimdReal sz = packet.oz[c] - v0.z;
+        SimdReal u = f * (sx * hx + sy * hy + sz * hz);
+
+        // q = s x edge1
+        SimdReal qx = sy * edge1.z - sz * edge1.y;
+        SimdReal qy = sz * edge1.x - sx * edge1.z;
+        SimdReal qz = sx * edge1.y - sy * edge1.x;
+        SimdReal v = f * (packet.dx[c] * qx + packet.dy[c] * qy + packet.dz[c] * qz);
+        SimdReal t = f * (edge2.x * qx + edge2.y * qy + edge2.z * qz);
+
+        SimdMask accept = ((a >= EPSILON) | (a <= -EPSILON)) & (u >= 0) & (u <= 1) & (v >= 0) &
+                          (u + v <= 1) & (t >= EPSILON) & (t < hit.t[c]);
+        commitPacket(c, accept, t, hit, owner, primId);
+        for (int k = 0; k < SIMD_WIDTH; k++) {
+            if (accept[k]) {
+                hit.u[c * SIMD_WIDTH + k] = static_cast<float>(u[k]);
+                hit.v[c * SIMD_WIDTH + k] = static_cast<float>(v[k]);
+            }
+        }
+    }
+}
+
+bool Triangle::intersect(const Ray& ray, double tMax, HitRecord& rec) const {
+    if (!intersectTriangle(ray, v0, edge1, edge2, tMax, rec)) {
+        return false;
+    }
+    rec.object = this;
+    rec.primId = 0;
+    return true;
+}
+
+void Triangle::computeSurface(const Ray& ray, const HitRecord& rec, SurfaceRecord& surface) const {
+    surface.point = ray.at(rec.t);
+    surface.normal = normal;
+    surface.material = &material;
+}
+
+void Triangle::intersect(const RayPacket& packet, PacketHit& hit) const {
+    intersectTriangle(packet, hit, v0, edge1, edge2, this, 0);
+}
+
+// ============ TRIÂNGULOS EM LOTE (SoA) ============
+
+void TriangleBatch::clear() {
+    resize(0);
+}
+
+void TriangleBatch::resize(size_t count) {
+    for (auto* a : {&v0x, &v0y, &v0z, &e1x, &e1y, &e1z, &e2x, &e2y, &e2z}) {
+        a->assign(count, 0);
+    }
+}
+
+void TriangleBatch::set(size_t slot, const Vector3& v0, const Vector3& v1, const Vector3& v2) {
+    Vector3 edge1 = v1 - v0;
+    Vector3 edge2 = v2 - v0;
+    v0x[slot] = v0.x; v0y[slot] = v0.y; v0z[slot] = v0.z;
+    e1x[slot] = edge1.x; e1y[slot] = edge1.y; e1z[slot] = edge1.z;
+    e2x[slot] = edge2.x; e2y[slot] = edge2.y; e2z[slot] = edge2.z;
+}
+
+static inline SimdReal loadChunk(const std::vector<Real>& a, size_t first) {
+    SimdReal r;
+    std::memcpy(&r, &a[first], sizeof(r));
+    return r;
+}
+
+// Möller-Trumbore de um raio contra SIMD_WIDTH triângulos a partir de first
+// (mesma ordem de operações da versão escalar). Posições >= end são rejeitadas.
+static inline SimdMask intersectChunk(const TriangleBatch& b, const Ray& ray, size_t first, size_t end,
+                                      Real tMax, SimdReal& t, SimdReal& u, SimdReal& v) {
+    Real dx = ray.direction.x, dy = ray.direction.y, dz = ray.direction.z;
+    SimdReal e1x = loadChunk(b.e1x, first), e1y = loadChunk(b.e1y, first), e1z = loadChunk(b.e1z, first);
+    SimdReal e2x = loadChunk(b.e2x, first), e2y = loadChunk(b.e2y, first), e2z = loadChunk(b.e2z, first);
+
+    // h = direção x edge2
+    SimdReal hx = dy * e2z - dz * e2y;
+    SimdReal hy = dz * e2x - dx * e2z;
+    SimdReal hz = dx * e2y - dy * e2x;
+    SimdReal a = e1x * hx + e1y * hy + e1z * hz;
+
+    SimdReal f = 1 / a;
+    SimdReal sx = ray.origin.x - loadChunk(b.v0x, first);
+    SimdReal sy = ray.origin.y - loadChunk(b.v0y, first);
+    SimdReal sz = ray.origin.z - loadChunk(b.v0z, first);
+    u = f * (sx * hx + sy * hy + sz * hz);
+
+    // q = s x edge1
+    SimdReal qx = sy * e1z - sz * e1y;
+    SimdReal qy = sz * e1x - sx * e1z;
+    SimdReal qz = sx * e1y - sy * e1x;
+    v = f * (dx * qx + dy * qy + dz * qz);
+    t = f * (e2x * qx + e2y * qy + e2z * qz);
+
+    // Posições válidas pela contagem inteira (índices convertidos para
+    // float arredondariam acima de 2^24)
+    SimdMask inRange;
+    size_t remaining = end - first;
+    for (int k = 0; k < SIMD_WIDTH; k++) {
+        inRange[k] = static_cast<size_t>(k) < remaining ? -1 : 0;
+    }
+    return ((a >= EPSILON) | (a <= -EPSILON)) & (u >= 0) & (u <= 1) & (v >= 0) & (u + v <= 1) &
+           (t >= EPSILON) & (t < tMax) & inRange;
+}
+
+int TriangleBatch::intersect(const Ray& ray, uint32_t first, uint32_t count, double tMax, HitRecord& rec) const {
+    int best = -1;
+    Real closest = static_cast<Real>(tMax);
+    Real bestU = 0, bestV = 0;
+    for (size_t c = first; c < first + count; c += SIMD_WIDTH) {
+        SimdReal t, u, v;
+        SimdMask accept = intersectChunk(*this, ray, c, first + count, closest, t, u, v);
+        // Empate fica com o primeiro, como no laço triângulo a triângulo
+        for (int k = 0; k < SIMD_WIDTH; k++) {
+            if (accept[k] && t[k] < closest) {
+                closest = t[k];
+                bestU = u[k];
+                bestV = v[k];
+                best = static_cast<int>(c + k);
+            }
+        }
+    }
+    if (best >= 0) {
+        rec.t = closest;
+        rec.u = static_cast<float>(bestU);
+        rec.v = static_cast<float>(bestV);
+    }
+    return best;
+}
+
+bool TriangleBatch::occluded(const Ray& ray, uint32_t first, uint32_t count, double tMax) const {
+    for (size_t c = first; c < first + count; c += SIMD_WIDTH) {
+        SimdReal t, u, v;
+        SimdMask accept = intersectChunk(*this, ray, c, first + count, static_cast<Real>(tMax), t, u, v);
+        for (int k = 0; k < SIMD_WIDTH; k++) {
+            if (accept[k]) return true;
+        }
+    }
+    return false;
+}
+
+// ============ MALHA INDEXADA ============
+
+uint32_t Mesh::addVertex(const Vector3& p) {
+    positions.push_back(static_cast<float>(p.x));
+    positions.push_back(static_cast<float>(p.y));
+    positions.push_back(static_cast<float>(p.z));
+    return vertexCount() - 1;
+}
+
+uint32_t Mesh::addVertex(const Vector3& p, const Vector3& n, float u, float v) {
+    normals.push_back(static_cast<float>(n.x));
+    normals.push_back(static_cast<float>(n.y));
+    normals.push_back(static_cast<float>(n.z));
+    texcoords.push_back(u);
+    texcoords.push_back(v);
+    return addVertex(p);
+}
+
+uint32_t Mesh::addMaterial(const Material& mat) {
+    materials.push_back(mat);
+    return static_cast<uint32_t>(materials.size());
+}
+
+void Mesh::addTriangle(uint32_t i0, uint32_t i1, uint32_t i2, uint32_t materialId) {
+    // faceMaterials só é alocado quando aparece o primeiro material por face
+    if (materialId != 0 && faceMaterials.empty()) {
+        faceMaterials.assign(triangleCount(), 0);
+    }
+    if (!faceMaterials.empty()) {
+        faceMaterials.push_back(materialId);
+    }
+    indices.push_back(i0);
+    indices.push_back(i1);
+    indices.push_back(i2);
+    bvhDirty = true;
+}
+
+void Mesh::addTriangle(const Vector3& p0, const Vector3& p1, const Vector3& p2) {
+    uint32_t i0 = addVertex(p0);
+    uint32_t i1 = addVertex(p1);
+    uint32_t i2 = addVertex(p2);
+    addTriangle(i0, i1, i2);
+}
+
+// Sem BVH (malha em construção) as arestas saem dos vértices a cada teste
+bool Mesh::intersectTriangle(uint32_t primId, const Ray& ray, double tMax, HitRecord& rec) const {
+    const uint32_t* tri = &indices[3 * primId];
+    Vector3 v0 = vertex(tri[0]);
+    return ::intersectTriangle(ray, v0, vertex(tri[1]) - v0, vertex(tri[2]) - v0, tMax, rec);
+}
+
+void Mesh::intersectTriangle(uint32_t primId, const RayPacket& packet, PacketHit& hit) const {
+    const uint32_t* tri = &indices[3 * primId];
+    Vector3 v0 = vertex(tri[0]);
+    ::intersectTriangle(packet, hit, v0, vertex(tri[1]) - v0, vertex(tri[2]) - v0, this, primId);
+}
+
+AABB Mesh::triangleBounds(uint32_t primId) const {
+    const uint32_t* tri = &indices[3 * primId];
+    AABB box(vertex(tri[0]), vertex(tri[1]));
+    box.expand(vertex(tri[2]));
+    return box;
+}
+
+// MESH BVH
+void Mesh::buildBVH() {
+    std::vector<AABB> bounds;
+    bounds.reserve(triangleCount());
+    for (uint32_t i = 0; i < triangleCount(); i++) {
+        bounds.push_back(triangleBounds(i));
+    }
+    // Folhas de até PACKET_SIZE triângulos, testadas juntas por TriangleBatch
+    bvh.build(bounds, PACKET_SIZE, PACKET_SIZE);
+    buildBatch();
+}
+
+void Mesh::setBVH(BVH&& prebuilt) {
+    bvh = std::move(prebuilt);
+    buildBatch();
+}
+
+// Arestas na ordem de bvh.indices
+void Mesh::buildBatch() {
+    uint32_t n = triangleCount();
+    batch.resize(n == 0 ? 0 : n + SIMD_WIDTH - 1);
+    for (uint32_t slot = 0; slot < n; slot++) {
+        const uint32_t* tri = &indices[3 * bvh.indices[slot]];
+        batch.set(slot, vertex(tri[0]), vertex(tri[1]), vertex(tri[2]));
+    }
+    bvhDirty = false;
+}
+
 // MESH INTERSECTION
-bool Mesh::intersect(const Ray& ray, HitRecord& rec) const {
+// rec.object aponta para a Mesh e rec.primId para o triângulo atingido
+bool Mesh::intersect(const Ray& ray, double tMax, HitRecord& rec) const {
     bool hitAnything = false;
-    double closest = std::numeric_limits<double>::max();
-    HitRecord tempRec;
-
-    for (const auto& triangle : triangles) {
-        if (triangle.intersect(ray, tempRec) && tempRec.t < closest) {
-            closest = tempRec.t;
-            rec = tempRec;
-            rec.object = this;  // Aponta para a Mesh, não o triângulo
-            hitAnything = true;
+    double closest = tMax;
+
+    if (bvhDirty) {
+        for (uint32_t i = 0; i < triangleCount(); i++) {
+            if (intersectTriangle(i, ray, closest, rec)) {
+                closest = rec.t;
+                rec.primId = i;
+                hitAnything = true;
+            }
         }
+    } else {
+        hitAnything = bvh.intersectLeaves(ray, closest, [&](uint32_t first, uint32_t count, double& tMax) {
+            int slot = batch.intersect(ray, first, count, tMax, rec);
+            if (slot < 0) return false;
+            tMax = rec.t;
+            rec.primId = bvh.indices[slot];
+            return true;
+        });
     }
 
+    if (hitAnything) rec.object = this;
     return hitAnything;
 }
+
+// Normal da face, ou interpolada pelas baricêntricas se a malha tem normais
+void Mesh::computeSurface(const Ray& ray, const HitRecord& rec, SurfaceRecord& surface) const {
+    const uint32_t* tri = &indices[3 * rec.primId];
+    Real w = 1 - rec.u - rec.v;
+
+    surface.point = ray.at(rec.t);
+    if (normals.size() == positions.size()) {
+        Vector3 n0(normals[3 * tri[0]], normals[3 * tri[0] + 1], normals[3 * tri[0] + 2]);
+        Vector3 n1(normals[3 * tri[1]], normals[3 * tri[1] + 1], normals[3 * tri[1] + 2]);
+        Vector3 n2(normals[3 * tri[2]], normals[3 * tri[2] + 1], normals[3 * tri[2] + 2]);
+        surface.normal = (n0 * w + n1 * rec.u + n2 * rec.v).normalized();
+    } else {
+        Vector3 v0 = vertex(tri[0]);
+        surface.normal = (vertex(tri[1]) - v0).cross(vertex(tri[2]) - v0).normalized();
+    }
+    if (texcoords.size() / 2 == positions.size() / 3) {
+        surface.texU = static_cast<float>(w * texcoords[2 * tri[0]] + rec.u * texcoords[2 * tri[1]] +
+                                          rec.v * texcoords[2 * tri[2]]);
+        surface.texV = static_cast<float>(w * texcoords[2 * tri[0] + 1] + rec.u * texcoords[2 * tri[1] + 1] +
+                                          rec.v * texcoords[2 * tri[2] + 1]);
+    }
+    surface.material = &faceMaterial(rec.primId);
+}
+
+void Mesh::intersect(const RayPacket& packet, PacketHit& hit) const {
+    if (bvhDirty) {
+        for (uint32_t i = 0; i < triangleCount(); i++) {
+            intersectTriangle(i, packet, hit);
+        }
+        return;
+    }
+
+    // Cada triângulo da folha contra o pacote inteiro, com as arestas do lote
+    bvh.intersectLeaves(packet, hit.t, [&](uint32_t first, uint32_t count) {
+        for (uint32_t slot = first; slot < first + count; slot++) {
+            Vector3 v0(batch.v0x[slot], batch.v0y[slot], batch.v0z[slot]);
+            Vector3 edge1(batch.e1x[slot], batch.e1y[slot], batch.e1z[slot]);
+            Vector3 edge2(batch.e2x[slot], batch.e2y[slot], batch.e2z[slot]);
+            ::intersectTriangle(packet, hit, v0, edge1, edge2, this, bvh.indices[slot]);
+        }
+    });
+}
+
+// Para no primeiro triângulo que bloqueia o raio (travessia any-hit da BVH)
+bool Mesh::occluded(const Ray& ray, double tMax) const {
+    if (bvhDirty) {
+        HitRecord rec;
+        for (uint32_t i = 0; i < triangleCount(); i++) {
+            if (intersectTriangle(i, ray, tMax, rec)) return true;
+        }
+        return false;
+    }
+
+    return bvh.occludedLeaves(ray, tMax, [&](uint32_t first, uint32_t count, double tMax) {
+        return batch.occluded(ray, first, count, tMax);
+    });
+}
+
+// ============ CAIXAS ENVOLVENTES (AABB) ============
+
+// Extensão, por eixo, de um disco de raio r perpendicular a 'axis' (unitário)
+static Vector3 diskExtent(const Vector3& axis, double r) {
+    return Vector3(r * std::sqrt(std::max(0.0, 1.0 - axis.x * axis.x)),
+                   r * std::sqrt(std::max(0.0, 1.0 - axis.y * axis.y)),
+                   r * std::sqrt(std::max(0.0, 1.0 - axis.z * axis.z)));
+}
+
+AABB Sphere::boundingBox() const {
+    Vector3 r(radius, radius, radius);
+    return AABB(center - r, center + r);
+}
+
+AABB Plane::boundingBox() const {
+    return AABB::infinite();  // Plano é ilimitado: fica fora da BVH
+}
+
+AABB Cylinder::boundingBox() const {
+    Vector3 top = baseCenter + axis * height;
+    Vector3 e = diskExtent(axis, radius);
+    AABB box(baseCenter - e, baseCenter + e);
+    box.expand(AABB(top - e, top + e));
+    return box;
+}
+
+AABB Cone::boundingBox() const {
+    // Conservador: envolve discos de raio 'radius' nas duas extremidades do eixo
+    Vector3 top = baseCenter + axis * height;
+    Vector3 e = diskExtent(axis, radius);
+    AABB box(baseCenter - e, baseCenter + e);
+    box.expand(AABB(top - e, top + e));
+    return box;
+}
+
+AABB Triangle::boundingBox() const {
+    AABB box(v0, v1);
+    box.expand(v2);
+    return box;
+}
+
+AABB Mesh::boundingBox() const {
+    if (!bvhDirty && !bvh.empty()) {
+        return bvh.nodes[0].bounds;
+    }
+    AABB box;
+    for (uint32_t i = 0; i < triangleCount(); i++) {
+        box.expand(triangleBounds(i));
+    }
+    return box;
+}
@@ -1,13 +1,15 @@
 #include "../include/Scene.h"
-#include <fstream>
 #include <iostream>
 #include <algorithm>
 #include <cmath>
+#include <atomic>
+#include <mutex>
 
-Scene::Scene() : backgroundColor(0.1, 0.1, 0.15) {}
+Scene::Scene() : backgroundColor(0.1, 0.1, 0.15), bvhDirty(true) {}
 
 void Scene::addObject(std::shared_ptr<Object> obj) {
     objects.push_back(obj);
+    bvhDirty = true;
 }
 
 void Scene::addLight(std::shared_ptr<Light> light) {
@@ -26,43 +28,174 @@ void Scene::setAmbientLight(std::shared_ptr<AmbientLight> light) {
     ambientLight = light;
 }
 
+// ============ BVH ============
+
+void Scene::buildBVH() {
+    boundedObjects.clear();
+    unboundedObjects.clear();
+
+    std::vector<AABB> bounds;
+    for (const auto& obj : objects) {
+        obj->prepare();  // BVHs internas (malhas) antes das caixas finais
+        AABB box = obj->boundingBox();
+        if (box.isFinite()) {
+            boundedObjects.push_back(obj.get());
+            bounds.push_back(box);
+        } else {
+            unboundedObjects.push_back(obj.get());
+        }
+    }
+
+    bvh.build(bounds);
+    bvhDirty = false;
+}
+
 bool Scene::intersect(const Ray& ray, HitRecord& rec) const {
+    // Só distâncias: cada teste já descarta acertos além do mais próximo
     bool hitAnything = false;
-    double closest = std::numeric_limits<double>::max();
-    HitRecord tempRec;
-    
-    for (const auto& obj : objects) {
-        if (obj->intersect(ray, tempRec) && tempRec.t < closest) {
-            closest = tempRec.t;
-            rec = tempRec;
-            hitAnything = true;
+    double closest = ray.tMax;
+
+    if (bvhDirty) {
+        for (const auto& obj : objects) {
+            if (obj->intersect(ray, closest, rec)) {
+                closest = rec.t;
+                hitAnything = true;
+            }
         }
+    } else {
+        for (const Object* obj : unboundedObjects) {
+            if (obj->intersect(ray, closest, rec)) {
+                closest = rec.t;
+                hitAnything = true;
+            }
+        }
+
+        hitAnything |= bvh.intersect(ray, closest, [&](uint32_t index, double& tMax) {
+            if (boundedObjects[index]->intersect(ray, tMax, rec)) {
+                tMax = rec.t;
+                return true;
+            }
+            return false;
+        });
     }
-    
+
     return hitAnything;
 }
 
+bool Scene::occluded(const Ray& ray, double tMax) const {
+    if (bvhDirty) {
+        for (const auto& obj : objects) {
+            if (obj->occluded(ray, tMax)) return true;
+        }
+        return false;
+    }
+
+    for (const Object* obj : unboundedObjects) {
+        if (obj->occluded(ray, tMax)) return true;
+    }
+
+    return bvh.occluded(ray, tMax, [&](uint32_t index, double tMax) {
+        return boundedObjects[index]->occluded(ray, tMax);
+    });
+}
+
+void Scene::intersect(const RayPacket& packet, PacketHit& hit) const {
+    if (bvhDirty) {
+        for (const auto& obj : objects) {
+            obj->intersect(packet, hit);
+        }
+        return;
+    }
+
+    for (const Object* obj : unboundedObjects) {
+        obj->intersect(packet, hit);
+    }
+
+    bvh.intersect(packet, hit.t, [&](uint32_t index) {
+        boundedObjects[index]->intersect(packet, hit);
+    });
+}
+
+uint32_t Scene::occluded(const RayPacket& packet, const SimdReal* tMax) const {
+    PacketHit hit;
+    uint32_t pending = 0;
+    for (int k = 0; k < PACKET_SIZE; k++) {
+        if (packetLane(tMax, k) >= 0) pending |= 1u << k;
+    }
+    if (pending == 0) return 0;
+    for (int c = 0; c < PACKET_CHUNKS; c++) {
+        hit.t[c] = tMax[c];
+    }
+
+    // Raios bloqueados saem do pacote (t = -1); para quando não sobrar nenhum
+    uint32_t blocked = 0;
+    auto test = [&](const Object* obj) {
+        obj->intersect(packet, hit);
+        for (int k = 0; k < PACKET_SIZE; k++) {
+            if (hit.object[k]) {
+                blocked |= 1u << k;
+                hit.object[k] = nullptr;
+                setPacketLane(hit.t, k, -1);
+            }
+        }
+        return blocked == pending;
+    };
+
+    if (bvhDirty) {
+        for (const auto& obj : objects) {
+            if (test(obj.get())) break;
+        }
+        return blocked;
+    }
+
+    for (const Object* obj : unboundedObjects) {
+        if (test(obj)) return blocked;
+    }
+
+    bvh.occluded(packet, hit.t, [&](uint32_t index) {
+        return test(boundedObjects[index]);
+    });
+    return blocked;
+}
+
 bool Scene::isInShadow(const Vector3& point, const Vector3& lightPos) const {
     Vector3 toLight = lightPos - point;
     double distanceToLight = toLight.length();
     Vector3 directionToLight = toLight.normalized();
     
-    Ray shadowRay(point + directionToLight * 1e-4, directionToLight);
-    
-    HitRecord tempRec;
-    for (const auto& obj : objects) {
-        if (obj->intersect(shadowRay, tempRec) && tempRec.t < distanceToLight) {
-            return true;
+    Ray shadowRay(point + directionToLight * 1e-4, directionToLight, RayDirection::UNIT);
+    return occluded(shadowRay, distanceToLight);
+}
+
+// Pacote de raios de sombra dos pontos atingidos até a luz (mesma
+// construção de isInShadow); devolve a máscara dos pontos na sombra
+uint32_t Scene::shadowPacket(const SurfaceRecord* surfaces, const PacketHit& hit, int count,
+                             const Vector3& lightPos) const {
+    RayPacket packet;
+    SimdReal tMax[PACKET_CHUNKS];
+    for (int k = 0; k < PACKET_SIZE; k++) {
+        if (k >= count || !hit.object[k]) {
+            packet.set(k, Ray());
+            setPacketLane(tMax, k, -1);
+            continue;
         }
+        Vector3 toLight = lightPos - surfaces[k].point;
+        Vector3 directionToLight = toLight.normalized();
+        packet.set(k, Ray(surfaces[k].point + directionToLight * 1e-4, directionToLight, RayDirection::UNIT));
+        setPacketLane(tMax, k, toLight.length());
     }
-    
-    return false;
+    return occluded(packet, tMax);
+}
+
+Color Scene::computeLighting(const SurfaceRecord& surface, const Ray& ray) const {
+    return computeLighting(surface, ray, nullptr, 0);
 }
 
-Color Scene::computeLighting(const HitRecord& hit, const Ray& ray) const {
-    const Material& mat = hit.material;
-    Vector3 point = hit.point;
-    Vector3 normal = hit.normal;
+Color Scene::computeLighting(const SurfaceRecord& surface, const Ray& ray,
+                             const uint32_t* shadowMasks, int lane) const {
+    const Material& mat = *surface.material;
+    Vector3 point = surface.point;
+    Vector3 normal = surface.normal;
     Vector3 viewDir = -ray.direction;
     
     Color materialColor = mat.getDiffuseColor(point);
@@ -75,22 +208,25 @@ Color Scene::computeLighting(const HitRecord& hit, const Ray& ray) const {
     Color diffuse(0, 0, 0);
     Color specular(0, 0, 0);
     
+    size_t shadowIndex = 0;
     for (const auto& light : pointLights) {
         Vector3 lightDir = (light->position - point).normalized();
         
-        if (isInShadow(point, light->position)) {
+        bool shadowed = shadowMasks ? (shadowMasks[shadowIndex++] >> lane) & 1
+                                    : isInShadow(point, light->position);
+        if (shadowed) {
             continue;
         }
         
-        double nDotL = std::max(0.0, normal.dot(lightDir));
+        Real nDotL = std::max<Real>(0, normal.dot(lightDir));
         if (nDotL > 0) {
-            diffuse = diffuse + materialColor * light->intensity * nDotL;
+            diffuse = madd(materialColor * light->intensity, nDotL, diffuse);
             
             Vector3 reflectDir = lightDir.reflect(normal);
-            double vDotR = std::max(0.0, viewDir.dot(reflectDir));
+            Real vDotR = std::max<Real>(0, viewDir.dot(reflectDir));
             if (vDotR > 0) {
-                double specularFactor = std::pow(vDotR, mat.shininess);
-                specular = specular + mat.ks * light->intensity * specularFactor;
+                Real specularFactor = std::pow(vDotR, mat.shininess);
+                specular = madd(mat.ks * light->intensity, specularFactor, specular);
             }
         }
     }
@@ -98,15 +234,15 @@ Color Scene::computeLighting(const HitRecord& hit, const Ray& ray) const {
     for (const auto& light : directionalLights) {
         Vector3 lightDir = -light->direction;
         
-        double nDotL = std::max(0.0, normal.dot(lightDir));
+        Real nDotL = std::max<Real>(0, normal.dot(lightDir));
         if (nDotL > 0) {
-            diffuse = diffuse + materialColor * light->intensity * nDotL;
+            diffuse = madd(materialColor * light->intensity, nDotL, diffuse);
             
             Vector3 reflectDir = lightDir.reflect(normal);
-            double vDotR = std::max(0.0, viewDir.dot(reflectDir));
+            Real vDotR = std::max<Real>(0, viewDir.dot(reflectDir));
             if (vDotR > 0) {
-                double specularFactor = std::pow(vDotR, mat.shininess);
-                specular = specular + mat.ks * light->intensity * specularFactor;
+                Real specularFactor = std::pow(vDotR, mat.shininess);
+                specular = madd(mat.ks * light->intensity, specularFactor, specular);
             }
         }
     }
@@ -114,21 +250,23 @@ Color Scene::computeLighting(const HitRecord& hit, const Ray& ray) const {
     for (const auto& light : spotLights) {
         Vector3 lightDir = (light->position - point).normalized();
         
-        if (isInShadow(point, light->position)) {
+        bool shadowed = shadowMasks ? (shadowMasks[shadowIndex++] >> lane) & 1
+                                    : isInShadow(point, light->position);
+        if (shadowed) {
             continue;
         }
         
         Color lightIntensity = light->getIntensityAt(point);
         
-        double nDotL = std::max(0.0, normal.dot(lightDir));
+        Real nDotL = std::max<Real>(0, normal.dot(lightDir));
         if (nDotL > 0) {
-            diffuse = diffuse + materialColor * lightIntensity * nDotL;
+            diffuse = madd(materialColor * lightIntensity, nDotL, diffuse);
             
             Vector3 reflectDir = lightDir.reflect(normal);
-            double vDotR = std::max(0.0, viewDir.dot(reflectDir));
+            Real vDotR = std::max<Real>(0, viewDir.dot(reflectDir));
             if (vDotR > 0) {
-                double specularFactor = std::pow(vDotR, mat.shininess);
-                specular = specular + mat.ks * lightIntensity * specularFactor;
+                Real specularFactor = std::pow(vDotR, mat.shininess);
+                specular = madd(mat.ks * lightIntensity, specularFactor, specular);
             }
         }
     }
@@ -142,65 +280,157 @@ Color Scene::traceRay(const Ray& ray) const {
     HitRecord rec;
     
     if (intersect(ray, rec)) {
-        return computeLighting(rec, ray);
+        // Superfície montada uma única vez, para o acerto final
+        SurfaceRecord surface;
+        rec.object->computeSurface(ray, rec, surface);
+        return computeLighting(surface, ray);
     }
     
     return backgroundColor;
 }
 
+void Scene::tracePacket(const RayPacket& packet, int count, Color* colors) const {
+    PacketHit hit;
+    for (int k = count; k < PACKET_SIZE; k++) {
+        setPacketLane(hit.t, k, -1);  // Posições sem pixel
+    }
+    intersect(packet, hit);
+
+    SurfaceRecord surfaces[PACKET_SIZE];
+    bool anyHit = false;
+    for (int k = 0; k < count; k++) {
+        if (hit.object[k]) {
+            hit.object[k]->computeSurface(packet.get(k), hit.record(k), surfaces[k]);
+            anyHit = true;
+        }
+    }
+
+    if (anyHit) {
+        // Um pacote de raios de sombra por luz, com todos os pontos atingidos
+        std::vector<uint32_t> shadowMasks;
+        shadowMasks.reserve(pointLights.size() + spotLights.size());
+        for (const auto& light : pointLights) {
+            shadowMasks.push_back(shadowPacket(surfaces, hit, count, light->position));
+        }
+        for (const auto& light : spotLights) {
+            shadowMasks.push_back(shadowPacket(surfaces, hit, count, light->position));
+        }
+
+        for (int k = 0; k < count; k++) {
+            if (hit.object[k]) {
+                colors[k] = computeLighting(surfaces[k], packet.get(k), shadowMasks.data(), k);
+            }
+        }
+    }
+
+    for (int k = 0; k < count; k++) {
+        if (!hit.object[k]) colors[k] = backgroundColor;
+    }
+}
+
 Renderer::Renderer(Scene& scene, Camera& camera)
-    : scene(scene), camera(camera) {}
+    : Renderer(scene, camera, std::make_shared<ThreadPool>()) {}
+
+Renderer::Renderer(Scene& scene, Camera& camera, std::shared_ptr<ThreadPool> pool)
+    : scene(scene), camera(camera), tileSize(16),
+      outputFormat(PPMFormat::BINARY_P6), streamOutput(false),
+      framebufferFormat(PixelFormat::RGB32F), packetTracing(true), pool(pool) {}
+
+void Renderer::setThreadCount(int numThreads) {
+    pool = std::make_shared<ThreadPool>(numThreads);
+}
 
 void Renderer::render(const std::string& filename) {
     int width = camera.imageWidth;
     int height = camera.imageHeight;
-    
-    std::vector<std::vector<Color>> image(height, std::vector<Color>(width));
-    
-    std::cout << "Renderizando cena " << width << "x" << height << "..." << std::endl;
-    
-    for (int j = 0; j < height; j++) {
-        if (j % 50 == 0) {
-            std::cout << "Linha " << j << "/" << height << std::endl;
+
+    // Framebuffer contíguo com linhas alinhadas; não é usado no modo streaming
+    PPMStreamWriter stream;
+    if (streamOutput) {
+        if (!stream.open(filename, width, height, outputFormat)) return;
+        framebuffer = Framebuffer();
+    } else if (framebuffer.getWidth() != width || framebuffer.getHeight() != height ||
+               framebuffer.getFormat() != framebufferFormat) {
+        framebuffer.resize(width, height, framebufferFormat);
+    }
+
+    scene.buildBVH();
+
+    // Tabelas de raios primários do quadro, compartilhadas (só leitura) pelas threads
+    CameraRayGenerator rays(camera);
+
+    // Divide a imagem em tiles servidos por um contador atômico do pool
+    int tilesX = (width + tileSize - 1) / tileSize;
+    int tilesY = (height + tileSize - 1) / tileSize;
+    int totalTiles = tilesX * tilesY;
+
+    std::cout << "Renderizando cena " << width << "x" << height << " ("
+              << totalTiles << " tiles, " << pool->size() << " threads)..." << std::endl;
+
+    std::atomic<int> tilesDone(0);
+    std::mutex progressMutex;
+
+    pool->parallelFor(totalTiles, [&](int tile) {
+        int x0 = (tile % tilesX) * tileSize;
+        int y0 = (tile / tilesX) * tileSize;
+        int x1 = std::min(x0 + tileSize, width);
+        int y1 = std::min(y0 + tileSize, height);
+
+        // Renderiza uma linha do tile por vez e grava o trecho no
+        // framebuffer (ou direto no arquivo, no modo streaming)
+        Color span[64];
+        for (int j = y0; j < y1; j++) {
+            for (int i = x0; i < x1; i += 64) {
+                int count = std::min(64, x1 - i);
+                if (packetTracing) {
+                    // Pixels vizinhos em pacotes; as posições que sobram no
+                    // fim da linha repetem o último raio e são descartadas
+                    RayPacket packet;
+                    for (int k = 0; k < count; k += PACKET_SIZE) {
+                        int lanes = std::min(PACKET_SIZE, count - k);
+                        for (int lane = 0; lane < PACKET_SIZE; lane++) {
+                            packet.set(lane, rays.getRay(i + k + std::min(lane, lanes - 1), j));
+                        }
+                        scene.tracePacket(packet, lanes, span + k);
+                    }
+                } else {
+                    for (int k = 0; k < count; k++) {
+                        span[k] = scene.traceRay(rays.getRay(i + k, j));
+                    }
+                }
+                if (streamOutput) {
+                    stream.writeSpan(i, j, span, count);
+                } else {
+                    framebuffer.writeSpan(i, j, span, count);
+                }
+            }
         }
-        
-        for (int i = 0; i < width; i++) {
-            Ray ray = camera.getRay(i, j);
-            Color pixelColor = scene.traceRay(ray);
-            image[j][i] = pixelColor;
+
+        // Progresso a cada 10% dos tiles
+        int done = ++tilesDone;
+        if (done * 10 / totalTiles != (done - 1) * 10 / totalTiles) {
+            std::lock_guard<std::mutex> lock(progressMutex);
+            std::cout << "Progresso: " << done * 100 / totalTiles << "%" << std::endl;
         }
+    });
+
+    if (streamOutput) {
+        if (stream.close()) {
+            std::cout << "Imagem salva: " << filename << std::endl;
+        } else {
+            std::cerr << "Erro ao gravar arquivo: " << filename << std::endl;
+        }
+        return;
     }
     
     std::cout << "Salvando imagem..." << std::endl;
-    savePPM(filename, image);
+    savePPM(filename, framebuffer);
 }
 
-void Renderer::savePPM(const std::string& filename, const std::vector<std::vector<Color>>& image) {
-    std::ofstream file(filename, std::ios::binary);
-    
-    if (!file.is_open()) {
-        std::cerr << "Erro ao abrir arquivo: " << filename << std::endl;
-        return;
-    }
-    
-    int height = image.size();
-    int width = image[0].size();
-    
-    file << "P3\n" << width << " " << height << "\n255\n";
-    
-    for (int j = 0; j < height; j++) {
-        for (int i = 0; i < width; i++) {
-            const Color& color = image[j][i];
-            int r = static_cast<int>(255.99 * color.r);
-            int g = static_cast<int>(255.99 * color.g);
-            int b = static_cast<int>(255.99 * color.b);
-            
-            file << r << " " << g << " " << b << "\n";
-        }
+void Renderer::savePPM(const std::string& filename, const Framebuffer& image) {
+    if (writePPM(filename, image, outputFormat)) {
+        std::cout << "Imagem salva: " << filename << std::endl;
     }
-    
-    file.close();
-    std::cout << "Imagem salva: " << filename << std::endl;
 }
 
 // ============ PICKING ============
@@ -221,7 +451,7 @@ PickResult Scene::pick(const Camera& camera, int pixelX, int pixelY) const {
     if (intersect(ray, rec)) {
         result.hit = true;
         result.object = rec.object;
-        result.hitPoint = rec.point;
+        result.hitPoint = ray.at(rec.t);
         result.distance = rec.t;
 
         if (rec.object) {
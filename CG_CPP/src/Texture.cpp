@@ -1,6 +1,12 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include "../include/stb_image.h"
 #include "../include/Texture.h"
+#include "../include/MappedFile.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <iostream>
 #include <cmath>
 
@@ -8,68 +14,479 @@ using namespace std;
 
 // ============ CLASSE TEXTURE ============
 
-Texture::Texture() : data(nullptr), width(0), height(0), channels(0), loaded(false) {}
+Texture::Texture() : layout(TextureLayout::LINEAR), loaded(false), pixels(nullptr) {}
 
-Texture::Texture(const std::string& filename) : data(nullptr), width(0), height(0), channels(0), loaded(false) {
+Texture::Texture(const std::string& filename) : layout(TextureLayout::LINEAR), loaded(false), pixels(nullptr) {
     load(filename);
 }
 
-Texture::~Texture() {
-    if (data) {
-        stbi_image_free(data);
-        data = nullptr;
-    }
-}
+Texture::~Texture() {}
 
-bool Texture::load(const std::string& filename) {
-    std::cout << "Carregando textura: " << filename << std::endl;
+bool Texture::load(const std::string& filename, TextureLayout newLayout) {
+    // Cada mensagem sai numa escrita só: a carga pode rodar em várias threads
+    std::cout << "Carregando textura: " + filename + "\n" << std::flush;
 
     // Libera textura anterior se existir
-    if (data) {
-        stbi_image_free(data);
-        data = nullptr;
-    }
+    texels.clear();
+    levels.clear();
+    mapping.reset();
+    pixels = nullptr;
+    layout = TextureLayout::LINEAR;
+    loaded = false;
 
-    // Força carregar 3 canais (RGB)
-    data = stbi_load(filename.c_str(), &width, &height, &channels, 3);
+    // Força 4 canais (RGBA; sem alfa na imagem, o stb preenche com 255)
+    int width, height, channels;
+    unsigned char* data = stbi_load(filename.c_str(), &width, &height, &channels, 4);
 
     if (!data) {
-        std::cerr << "  ✗ ERRO ao carregar: " << stbi_failure_reason() << std::endl;
-        loaded = false;
+        std::cerr << "  ✗ ERRO ao carregar " + filename + ": " + stbi_failure_reason() + "\n" << std::flush;
         return false;
     }
 
-    channels = 3;  // Forçamos RGB
+    levels.push_back(MipLevel{width, height, 0, 0});
+    texels.assign(data, data + static_cast<size_t>(width) * height * 4);
+    stbi_image_free(data);
+    buildMipmaps();
+    setLayout(newLayout);
+
     loaded = true;
-    std::cout << "  ✓ Carregada: " << width << "x" << height << " (" << channels << " canais)" << std::endl;
+    std::cout << "  ✓ Carregada: " + filename + " " + std::to_string(width) + "x" + std::to_string(height) +
+                     " (" + std::to_string(channels) + " canais, " + std::to_string(levels.size()) +
+                     " níveis de mipmap)\n" << std::flush;
     return true;
 }
 
+// Cada nível é a média 2x2 do anterior (dimensões ímpares repetem a última
+// linha/coluna), até 1x1. Gerado na organização LINEAR.
+void Texture::buildMipmaps() {
+    size_t total = texels.size();
+    for (int w = levels[0].width, h = levels[0].height; w > 1 || h > 1;) {
+        w = std::max(1, w / 2);
+        h = std::max(1, h / 2);
+        total += static_cast<size_t>(w) * h * 4;
+    }
+    texels.reserve(total);
+    pixels = texels.data();
+
+    while (levels.back().width > 1 || levels.back().height > 1) {
+        MipLevel src = levels.back();
+        MipLevel dst{std::max(1, src.width / 2), std::max(1, src.height / 2), 0, texels.size() / 4};
+        texels.resize(texels.size() + static_cast<size_t>(dst.width) * dst.height * 4);
+
+        for (int y = 0; y < dst.height; y++) {
+            int y0 = std::min(2 * y, src.height - 1);
+            int y1 = std::min(2 * y + 1, src.height - 1);
+            for (int x = 0; x < dst.width; x++) {
+                int x0 = std::min(2 * x, src.width - 1);
+                int x1 = std::min(2 * x + 1, src.width - 1);
+                const unsigned char* a = texel(src, x0, y0);
+                const unsigned char* b = texel(src, x1, y0);
+                const unsigned char* c = texel(src, x0, y1);
+                const unsigned char* d = texel(src, x1, y1);
+                unsigned char* out = &texels[(dst.offset + static_cast<size_t>(y) * dst.width + x) * 4];
+                for (int k = 0; k < 4; k++) {
+                    out[k] = static_cast<unsigned char>((a[k] + b[k] + c[k] + d[k] + 2) / 4);
+                }
+            }
+        }
+        levels.push_back(dst);
+    }
+}
+
+// Texels ocupados por um nível: nos blocos, largura e altura são
+// completadas até múltiplos de TEXTURE_TILE_SIZE
+size_t Texture::levelTexelCount(const MipLevel& level, TextureLayout layout) {
+    if (layout == TextureLayout::LINEAR) {
+        return static_cast<size_t>(level.width) * level.height;
+    }
+    size_t tilesY = (level.height + TEXTURE_TILE_SIZE - 1) / TEXTURE_TILE_SIZE;
+    return static_cast<size_t>(level.tilesX) * tilesY * TEXTURE_TILE_SIZE * TEXTURE_TILE_SIZE;
+}
+
+void Texture::setLayout(TextureLayout newLayout) {
+    if (newLayout == layout || levels.empty()) {
+        layout = newLayout;
+        return;
+    }
+
+    std::vector<MipLevel> newLevels = levels;
+    size_t total = 0;
+    for (MipLevel& level : newLevels) {
+        level.tilesX = (level.width + TEXTURE_TILE_SIZE - 1) / TEXTURE_TILE_SIZE;
+        level.offset = total;
+        total += levelTexelCount(level, newLayout);
+    }
+
+    // Cada texel é lido na organização antiga e escrito na nova; a borda
+    // dos blocos fica zerada (nunca é amostrada)
+    Texture converted;
+    converted.texels.assign(total * 4, 0);
+    converted.levels = newLevels;
+    converted.layout = newLayout;
+    for (size_t i = 0; i < levels.size(); i++) {
+        for (int y = 0; y < levels[i].height; y++) {
+            for (int x = 0; x < levels[i].width; x++) {
+                std::copy_n(texel(levels[i], x, y), 4,
+                            &converted.texels[(converted.rowIndex(newLevels[i], y) + converted.columnIndex(x)) * 4]);
+            }
+        }
+    }
+
+    texels.swap(converted.texels);
+    levels.swap(converted.levels);
+    layout = newLayout;
+    pixels = texels.data();
+    mapping.reset();
+}
+
 Color Texture::sample(double u, double v) const {
-    if (!loaded || !data) {
+    if (!loaded) {
+        return Color(1.0, 0.0, 1.0);  // Magenta = textura faltando
+    }
+    return sampleNearest(levels[0], u, v);
+}
+
+Color Texture::sample(double u, double v, double lod, TextureFilter filter) const {
+    if (!loaded) {
         return Color(1.0, 0.0, 1.0);  // Magenta = textura faltando
     }
 
+    double maxLod = static_cast<double>(levels.size() - 1);
+    lod = std::max(0.0, std::min(lod, maxLod));
+
+    switch (filter) {
+        case TextureFilter::NEAREST:
+            return sampleNearest(levels[static_cast<int>(lod + 0.5)], u, v);
+        case TextureFilter::BILINEAR:
+            return sampleBilinear(levels[static_cast<int>(lod + 0.5)], u, v);
+        case TextureFilter::TRILINEAR:
+        default: {
+            int level = static_cast<int>(lod);
+            double t = lod - level;
+            Color fine = sampleBilinear(levels[level], u, v);
+            if (t == 0.0) return fine;
+            Color coarse = sampleBilinear(levels[level + 1], u, v);
+            return fine * (1.0 - t) + coarse * t;
+        }
+    }
+}
+
+Color Texture::sampleNearest(const MipLevel& level, double u, double v) const {
     // Garante UV em [0, 1] com wrapping
     u = u - floor(u);
     v = v - floor(v);
 
     // Converte para coordenadas de pixel
-    int x = static_cast<int>(u * (width - 1));
-    int y = static_cast<int>((1.0 - v) * (height - 1));  // Inverte V
+    int x = static_cast<int>(u * (level.width - 1));
+    int y = static_cast<int>((1.0 - v) * (level.height - 1));  // Inverte V
 
     // Garante dentro dos limites
-    x = std::max(0, std::min(x, width - 1));
-    y = std::max(0, std::min(y, height - 1));
+    x = std::max(0, std::min(x, level.width - 1));
+    y = std::max(0, std::min(y, level.height - 1));
+
+    // Acessa pixel (RGB) e converte para [0, 1]
+    const unsigned char* p = texel(level, x, y);
+    return Color(p[0] / 255.0, p[1] / 255.0, p[2] / 255.0);
+}
+
+// Interpola os 4 texels em volta de (u, v), com centros em (i + 0.5) / largura
+// e repetição nas bordas
+Color Texture::sampleBilinear(const MipLevel& level, double u, double v) const {
+    double fx = (u - floor(u)) * level.width - 0.5;
+    double fy = (1.0 - (v - floor(v))) * level.height - 0.5;  // Inverte V
+    double floorX = floor(fx);
+    double floorY = floor(fy);
+    double tx = fx - floorX;
+    double ty = fy - floorY;
+
+    int x0 = static_cast<int>(floorX);
+    int y0 = static_cast<int>(floorY);
+    int x1 = x0 + 1;
+    int y1 = y0 + 1;
+    if (x0 < 0) x0 += level.width;
+    if (y0 < 0) y0 += level.height;
+    if (x1 >= level.width) x1 -= level.width;
+    if (y1 >= level.height) y1 -= level.height;
+
+    size_t row0 = rowIndex(level, y0);
+    size_t row1 = rowIndex(level, y1);
+    size_t column0 = columnIndex(x0);
+    size_t column1 = columnIndex(x1);
+    const unsigned char* a = texel(row0 + column0);
+    const unsigned char* b = texel(row0 + column1);
+    const unsigned char* c = texel(row1 + column0);
+    const unsigned char* d = texel(row1 + column1);
+
+    double rgb[3];
+    for (int k = 0; k < 3; k++) {
+        double top = a[k] + (b[k] - a[k]) * tx;
+        double bottom = c[k] + (d[k] - c[k]) * tx;
+        rgb[k] = (top + (bottom - top) * ty) / 255.0;
+    }
+    return Color(rgb[0], rgb[1], rgb[2]);
+}
+
+// ============ CACHE DE TEXTURA ============
+
+namespace {
+    const char TEXTURE_CACHE_MAGIC[8] = {'C', 'G', 'T', 'E', 'X', '\0', '\0', '\0'};
+    const uint64_t CACHE_ALIGNMENT = 64;
+    const uint32_t MAX_CACHE_LEVELS = 32;
+
+    struct TextureCacheHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t layout;        // TextureLayout
+        uint32_t levelCount;
+        uint32_t reserved;
+        uint64_t sourceSize;    // Imagem de origem: tamanho, data e hash (0 se não houver)
+        int64_t sourceTime;
+        uint64_t sourceHash;
+        uint64_t levelsOffset;  // Tabela de LevelRecord (bytes desde o início)
+        uint64_t texelsOffset;  // Texels RGBA8 de todos os níveis
+        uint64_t texelCount;
+    };
+
+    struct LevelRecord {
+        int32_t width;
+        int32_t height;
+        int32_t tilesX;
+        int32_t reserved;
+        uint64_t offset;  // Em texels
+    };
+
+    // FNV-1a de 64 bits do conteúdo inteiro
+    bool hashFile(const std::string& filename, uint64_t& hash) {
+        MappedFile file;
+        if (!file.open(filename)) return false;
+        hash = 14695981039346656037ull;
+        for (size_t i = 0; i < file.size(); i++) {
+            hash = (hash ^ static_cast<unsigned char>(file.data()[i])) * 1099511628211ull;
+        }
+        return true;
+    }
 
-    // Acessa pixel (RGB)
-    int index = (y * width + x) * 3;
-    unsigned char r = data[index + 0];
-    unsigned char g = data[index + 1];
-    unsigned char b = data[index + 2];
+    uint64_t alignCache(uint64_t offset) {
+        return (offset + CACHE_ALIGNMENT - 1) / CACHE_ALIGNMENT * CACHE_ALIGNMENT;
+    }
 
-    // Converte para [0, 1]
-    return Color(r / 255.0, g / 255.0, b / 255.0);
+    // Cabeçalho desta versão, com tabela e texels dentro do arquivo?
+    const TextureCacheHeader* checkHeader(const MappedFile& file) {
+        if (file.size() < sizeof(TextureCacheHeader)) return nullptr;
+        const TextureCacheHeader* header = reinterpret_cast<const TextureCacheHeader*>(file.data());
+        if (std::memcmp(header->magic, TEXTURE_CACHE_MAGIC, sizeof(header->magic)) != 0 ||
+            header->version != TEXTURE_CACHE_VERSION ||
+            header->layout > static_cast<uint32_t>(TextureLayout::MORTON) ||
+            header->levelCount == 0 || header->levelCount > MAX_CACHE_LEVELS ||
+            header->levelsOffset % CACHE_ALIGNMENT != 0 || header->texelsOffset % CACHE_ALIGNMENT != 0) {
+            return nullptr;
+        }
+        if (header->levelsOffset > file.size() ||
+            header->levelCount > (file.size() - header->levelsOffset) / sizeof(LevelRecord) ||
+            header->texelsOffset > file.size() ||
+            header->texelCount > (file.size() - header->texelsOffset) / 4) {
+            return nullptr;
+        }
+        return header;
+    }
+}
+
+bool Texture::writeCache(const std::string& filename, uint64_t sourceSize, int64_t sourceTime,
+                         uint64_t sourceHash) const {
+    if (!loaded) return false;
+
+    std::vector<LevelRecord> records;
+    for (const MipLevel& level : levels) {
+        records.push_back(LevelRecord{level.width, level.height, level.tilesX, 0, level.offset});
+    }
+
+    TextureCacheHeader header = {};
+    std::memcpy(header.magic, TEXTURE_CACHE_MAGIC, sizeof(header.magic));
+    header.version = TEXTURE_CACHE_VERSION;
+    header.layout = static_cast<uint32_t>(layout);
+    header.levelCount = static_cast<uint32_t>(levels.size());
+    header.sourceSize = sourceSize;
+    header.sourceTime = sourceTime;
+    header.sourceHash = sourceHash;
+    header.levelsOffset = alignCache(sizeof(header));
+    header.texelsOffset = alignCache(header.levelsOffset + records.size() * sizeof(LevelRecord));
+    header.texelCount = levels.back().offset + levelTexelCount(levels.back(), layout);
+
+    // Grava num temporário e renomeia: um leitor nunca vê um cache pela metade
+    std::string tempName = filename + ".tmp";
+    std::ofstream file(tempName, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Erro ao abrir arquivo: " + tempName + "\n" << std::flush;
+        return false;
+    }
+    const char padding[CACHE_ALIGNMENT] = {};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(padding, header.levelsOffset - sizeof(header));
+    file.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(LevelRecord));
+    file.write(padding, header.texelsOffset - header.levelsOffset - records.size() * sizeof(LevelRecord));
+    file.write(reinterpret_cast<const char*>(pixels), header.texelCount * 4);
+    file.close();
+    if (!file || std::rename(tempName.c_str(), filename.c_str()) != 0) {
+        std::cerr << "Erro ao gravar cache de textura: " + filename + "\n" << std::flush;
+        std::remove(tempName.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Adota um cache mapeado e com cabeçalho válido: a tabela de níveis tem que
+// ser a que load() produziria (cadeia até 1x1, níveis contíguos), senão a
+// amostragem poderia ler fora dos texels
+bool Texture::readCache(const std::shared_ptr<const MappedFile>& file, const std::string& filename) {
+    const TextureCacheHeader* header = checkHeader(*file);
+    if (!header) {
+        std::cerr << "Erro: cache de textura inválido ou de outra versão: " + filename + "\n" << std::flush;
+        return false;
+    }
+
+    TextureLayout cacheLayout = static_cast<TextureLayout>(header->layout);
+    const LevelRecord* records = reinterpret_cast<const LevelRecord*>(file->data() + header->levelsOffset);
+    std::vector<MipLevel> cacheLevels;
+    uint64_t total = 0;
+    bool consistent = records[0].width > 0 && records[0].height > 0;
+    for (uint32_t i = 0; consistent && i < header->levelCount; i++) {
+        const LevelRecord& r = records[i];
+        MipLevel level{r.width, r.height, r.tilesX, static_cast<size_t>(r.offset)};
+        if (i > 0) {
+            consistent = r.width == std::max(1, records[i - 1].width / 2) &&
+                         r.height == std::max(1, records[i - 1].height / 2);
+        }
+        if (cacheLayout != TextureLayout::LINEAR) {
+            consistent = consistent && r.tilesX == (r.width + TEXTURE_TILE_SIZE - 1) / TEXTURE_TILE_SIZE;
+        }
+        consistent = consistent && r.offset == total;
+        total += levelTexelCount(level, cacheLayout);
+        cacheLevels.push_back(level);
+    }
+    const LevelRecord& last = records[header->levelCount - 1];
+    if (!consistent || last.width != 1 || last.height != 1 || total != header->texelCount) {
+        std::cerr << "Erro: cache de textura corrompido: " + filename + "\n" << std::flush;
+        return false;
+    }
+
+    texels.clear();
+    texels.shrink_to_fit();
+    levels = std::move(cacheLevels);
+    layout = cacheLayout;
+    mapping = file;
+    pixels = reinterpret_cast<const unsigned char*>(file->data() + header->texelsOffset);
+    loaded = true;
+    return true;
+}
+
+bool Texture::saveCache(const std::string& cacheFilename) const {
+    return writeCache(cacheFilename, 0, 0, 0);
+}
+
+bool Texture::loadCache(const std::string& cacheFilename) {
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(cacheFilename)) return false;
+    return readCache(file, cacheFilename);
+}
+
+bool Texture::loadCached(const std::string& filename, TextureLayout newLayout, const std::string& cacheFilename) {
+    std::string cacheName = cacheFilename.empty() ? filename + ".cache" : cacheFilename;
+
+    uint64_t sourceSize;
+    int64_t sourceTime;
+    if (!fileStamp(filename, sourceSize, sourceTime)) {
+        return load(filename, newLayout);  // Mesma mensagem de erro da carga normal
+    }
+
+    // Cache gerado a partir desta mesma imagem? (sem cache, sem mensagem de erro)
+    uint64_t sourceHash = 0;
+    bool hashed = false;
+    uint64_t cacheSize;
+    int64_t cacheTime;
+    auto cache = std::make_shared<MappedFile>();
+    if (fileStamp(cacheName, cacheSize, cacheTime) && cache->open(cacheName)) {
+        const TextureCacheHeader* header = checkHeader(*cache);
+        bool fresh = header && header->sourceSize == sourceSize;
+        if (fresh && header->sourceTime != sourceTime) {
+            // Data diferente (ex: checkout): vale se o conteúdo é o mesmo
+            hashed = hashFile(filename, sourceHash);
+            fresh = hashed && sourceHash == header->sourceHash;
+        }
+        if (fresh && readCache(cache, cacheName)) {
+            if (layout != newLayout) {
+                // Cache de outra organização: reorganiza uma vez, regrava e
+                // volta a amostrar do mapeamento do arquivo novo
+                uint64_t cachedHash = hashed ? sourceHash : header->sourceHash;
+                setLayout(newLayout);
+                if (writeCache(cacheName, sourceSize, sourceTime, cachedHash)) {
+                    auto rewritten = std::make_shared<MappedFile>();
+                    if (rewritten->open(cacheName)) {
+                        readCache(rewritten, cacheName);
+                    }
+                }
+            }
+            std::cout << "  ✓ Cache: " + cacheName + " " + std::to_string(getWidth()) + "x" +
+                             std::to_string(getHeight()) + " (" + std::to_string(levels.size()) +
+                             " níveis de mipmap)\n" << std::flush;
+            return true;
+        }
+    }
+    cache.reset();
+
+    if (!load(filename, newLayout)) return false;
+    if (!hashed) hashed = hashFile(filename, sourceHash);
+    if (hashed) writeCache(cacheName, sourceSize, sourceTime, sourceHash);
+    return true;
+}
+
+// ============ CARREGAMENTO ASSÍNCRONO ============
+
+TextureLoader::TextureLoader(ThreadPool& pool) : pool(pool) {}
+
+TextureLoader::~TextureLoader() {
+    for (auto& job : jobs) {
+        if (job->done.valid()) job->done.wait();
+    }
+}
+
+void TextureLoader::load(const std::string& filename, Texture& target, TextureLayout layout) {
+    auto job = std::make_unique<Job>();
+    job->target = &target;
+    job->texture = std::make_unique<Texture>();
+    job->loaded = false;
+
+    // A tarefa só escreve no próprio Job (endereço estável: unique_ptr)
+    Job* pendingJob = job.get();
+    job->done = pool.submit([pendingJob, filename, layout] {
+        pendingJob->loaded = pendingJob->texture->loadCached(filename, layout);
+    });
+    jobs.push_back(std::move(job));
+}
+
+int TextureLoader::install() {
+    int installed = 0;
+    for (size_t i = 0; i < jobs.size();) {
+        Job& job = *jobs[i];
+        if (job.done.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            i++;
+            continue;
+        }
+
+        job.done.get();
+        if (job.loaded) {
+            *job.target = std::move(*job.texture);
+            installed++;
+        }
+        jobs.erase(jobs.begin() + i);
+    }
+    return installed;
+}
+
+void TextureLoader::finish() {
+    for (auto& job : jobs) {
+        job->done.wait();
+    }
+    install();
 }
 
 // ============ TEXTURE MANAGER ============
@@ -82,8 +499,15 @@ void TextureManager::loadTextures() {
     std::cout << "CARREGANDO TEXTURAS" << endl;
     std::cout << "========================================" << endl;
 
-    woodTexture = std::make_shared<Texture>("textures/wood.jpg");
-    stainedGlassTexture = std::make_shared<Texture>("textures/stained_glass.jpg");
+    // As duas decodificações rodam em paralelo
+    woodTexture = std::make_shared<Texture>();
+    stainedGlassTexture = std::make_shared<Texture>();
+
+    ThreadPool pool;
+    TextureLoader loader(pool);
+    loader.load("textures/wood.jpg", *woodTexture);
+    loader.load("textures/stained_glass.jpg", *stainedGlassTexture);
+    loader.finish();
 
     std::cout << "========================================\n" << endl;
 }
@@ -0,0 +1,121 @@
+#include "../include/ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(int numThreads)
+    : currentTask(nullptr), taskCount(0), nextIndex(0),
+      busyWorkers(0), generation(0), stopping(false) {
+    if (numThreads <= 0) {
+        numThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+
+    for (int i = 0; i < numThreads - 1; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::runTasks(const std::function<void(int)>& task, int count) {
+    for (int i = nextIndex.fetch_add(1); i < count; i = nextIndex.fetch_add(1)) {
+        task(i);
+    }
+}
+
+void ThreadPool::workerLoop() {
+    uint64_t seenGeneration = 0;
+
+    while (true) {
+        const std::function<void(int)>* task = nullptr;
+        int count = 0;
+        std::packaged_task<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeCondition.wait(lock, [&] {
+                return stopping || generation != seenGeneration || !jobs.empty();
+            });
+            if (stopping) return;
+
+            // Lote novo tem preferência; lote já concluído antes desta
+            // thread acordar não tem nada a fazer
+            if (generation != seenGeneration) {
+                seenGeneration = generation;
+                if (currentTask) {
+                    task = currentTask;
+                    count = taskCount;
+                    busyWorkers++;
+                }
+            }
+            if (!task) {
+                if (jobs.empty()) continue;
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+        }
+
+        if (!task) {
+            job();
+            continue;
+        }
+
+        runTasks(*task, count);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busyWorkers--;
+        }
+        doneCondition.notify_one();
+    }
+}
+
+std::future<void> ThreadPool::submit(std::function<void()> task) {
+    std::packaged_task<void()> job(std::move(task));
+    std::future<void> result = job.get_future();
+
+    if (workers.empty()) {
+        job();
+        return result;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(std::move(job));
+    }
+    wakeCondition.notify_one();
+    return result;
+}
+
+void ThreadPool::parallelFor(int count, const std::function<void(int)>& task) {
+    if (count <= 0) return;
+
+    if (workers.empty()) {
+        for (int i = 0; i < count; i++) task(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentTask = &task;
+        taskCount = count;
+        nextIndex.store(0);
+        generation++;
+    }
+    wakeCondition.notify_all();
+
+    // A thread chamadora também consome tarefas
+    runTasks(task, count);
+
+    // Espera as threads que ainda estão executando tarefas deste lote
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCondition.wait(lock, [&] { return busyWorkers == 0; });
+    currentTask = nullptr;
+}
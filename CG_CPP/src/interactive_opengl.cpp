@@ -5,7 +5,6 @@
 #include <vector>
 #include <cmath>
 #include <algorithm>
-#include <thread>
 #include <atomic>
 #include <limits>
 #include <chrono>
@@ -16,12 +15,18 @@
 #include "../include/Ray.h"
 #include "../include/Texture.h"
 #include "../include/Matrix4x4.h"
+#include "../include/ThreadPool.h"
+#include "../include/Framebuffer.h"
 
 using namespace std;
 
 const int WIDTH = 800;
 const int HEIGHT = 600;
 
+// Render configuration (tiles distribuídos dinamicamente entre as threads)
+const int RENDER_TILE_SIZE = 16;
+const int RENDER_THREADS = 0;  // 0 = todos os núcleos (hardware_concurrency)
+
 // Camera configuration
 const Vector3 CAMERA_POSITION(6, 1.8, 2);
 const Vector3 CAMERA_LOOKAT(6, 1.5, 10);
@@ -93,6 +98,19 @@ struct Camera {
     Vector3 up;
     float fov;
 
+    // Raios primários do quadro: base da câmera, termos por coluna/linha e a
+    // direção fixa das projeções paralelas, refeitos por prepareRays() só
+    // quando a câmera, a projeção ou a resolução mudam
+    vector<Vector3> columnTerms;
+    vector<Vector3> rowTerms;
+    Vector3 rayBase;        // forward (perspectiva) ou position (paralelas)
+    Vector3 parallelDir;    // Direção comum das projeções paralelas
+    Vector3 columnStep;     // Variação do termo de coluna/linha por pixel
+    Vector3 rowStep;        // (diferenciais de raio)
+    Vector3 cachedPosition, cachedLookAt, cachedUp;
+    float cachedFov = -1.0f;
+    int cachedProjection = -1;
+
     Camera() : position(CAMERA_POSITION), lookAt(CAMERA_LOOKAT), up(CAMERA_UP), fov(CAMERA_FOV) {}
 
     Ray generateRay(float px, float py, float aspectRatio) const {
@@ -144,7 +162,85 @@ struct Camera {
             }
         }
 
-        return Ray(rayOrigin, rayDir.normalized());
+        return Ray(rayOrigin, rayDir.normalized(), RayDirection::UNIT);
+    }
+
+    // Mesmas expressões de generateRay, avaliadas uma vez por coluna/linha
+    void prepareRays(int width, int height) {
+        if (cachedProjection == currentProjection && cachedFov == fov &&
+            (int)columnTerms.size() == width && (int)rowTerms.size() == height &&
+            cachedPosition.x == position.x && cachedPosition.y == position.y && cachedPosition.z == position.z &&
+            cachedLookAt.x == lookAt.x && cachedLookAt.y == lookAt.y && cachedLookAt.z == lookAt.z &&
+            cachedUp.x == up.x && cachedUp.y == up.y && cachedUp.z == up.z) {
+            return;
+        }
+
+        Vector3 forward = (lookAt - position).normalized();
+        Vector3 right = forward.cross(up).normalized();
+        Vector3 newUp = right.cross(forward);
+        float aspectRatio = (float)width / (float)height;
+
+        // Perspectiva: direção = forward + coluna + linha; paralelas: origem = position + coluna + linha
+        float scale;
+        if (currentProjection == PROJECTION_PERSPECTIVE) {
+            scale = tan(fov * 0.5f * M_PI / 180.0f);  // tanFov
+            rayBase = forward;
+        } else {
+            scale = 5.0f; // Escala da vista ortográfica/oblíqua
+            rayBase = position;
+
+            Vector3 rayDir = forward;
+            if (currentProjection == PROJECTION_OBLIQUE_CAV || currentProjection == PROJECTION_OBLIQUE_CAB) {
+                bool cavalier = currentProjection == PROJECTION_OBLIQUE_CAV;
+                float angle = (cavalier ? 45.0f : 63.4f) * M_PI / 180.0f;
+                float factor = cavalier ? 1.0f : 0.5f;
+                Vector3 oblique = right * (cos(angle) * factor) + newUp * (sin(angle) * factor);
+                rayDir = forward + oblique;
+            }
+            parallelDir = rayDir.normalized();
+        }
+
+        columnTerms.resize(width);
+        rowTerms.resize(height);
+        for (int x = 0; x < width; x++) {
+            float px = (2.0f * x / width - 1.0f);
+            columnTerms[x] = right * (px * scale * aspectRatio);
+        }
+        for (int y = 0; y < height; y++) {
+            float py = (1.0f - 2.0f * y / height);
+            rowTerms[y] = newUp * (py * scale);
+        }
+        columnStep = right * (2.0f / width * scale * aspectRatio);
+        rowStep = newUp * (-2.0f / height * scale);
+
+        cachedPosition = position;
+        cachedLookAt = lookAt;
+        cachedUp = up;
+        cachedFov = fov;
+        cachedProjection = currentProjection;
+    }
+
+    // Raio do pixel (x, y); exige prepareRays() com a resolução do quadro
+    Ray primaryRay(int x, int y) const {
+        Vector3 v = rayBase + columnTerms[x] + rowTerms[y];
+        if (currentProjection == PROJECTION_PERSPECTIVE) {
+            return Ray(position, v.normalized(), RayDirection::UNIT);
+        }
+        return Ray(v, parallelDir, RayDirection::UNIT);
+    }
+
+    // Diferenciais do raio do pixel (x, y) em relação aos pixels vizinhos
+    RayDifferential primaryDifferential(int x, int y) const {
+        RayDifferential diff;
+        if (currentProjection == PROJECTION_PERSPECTIVE) {
+            Vector3 v = rayBase + columnTerms[x] + rowTerms[y];
+            diff.dDdx = RayDifferential::normalizedDerivative(v, columnStep);
+            diff.dDdy = RayDifferential::normalizedDerivative(v, rowStep);
+        } else {
+            diff.dOdx = columnStep;
+            diff.dOdy = rowStep;
+        }
+        return diff;
     }
 
     void moveForward(float speed) {
@@ -196,24 +292,24 @@ struct Light {
 };
 
 // Hit record para interseções
+// Objeto e material são índices em chapelPrimitives / chapelMaterials:
+// o nome do objeto só é consultado no picking
 struct HitRecord {
     bool hit;
     float t;
     Vector3 point;
     Vector3 normal;
-    Color color;
-    float shininess;
-    bool useTexture;
     double u, v;
-    const Texture* texture;
-    string objectName;  // Nome do objeto para picking
+    Vector3 dudP, dvdP;     // Gradiente de u e v em relação ao ponto (zero: sem mapeamento planar)
+    int objectId;
+    int materialId;
 
     HitRecord() : hit(false), t(numeric_limits<float>::max()),
-                  useTexture(false), u(0), v(0), texture(nullptr), objectName("") {}
+                  u(0), v(0), objectId(-1), materialId(-1) {}
 };
 
-// Função de interseção com esfera
-bool intersectSphere(const Ray& ray, const Vector3& center, float radius, HitRecord& rec) {
+// Distância até a esfera (sem ponto/normal): usada também pelas sombras
+bool sphereDistance(const Ray& ray, const Vector3& center, float radius, float& t) {
     Vector3 oc = ray.origin - center;
     float a = ray.direction.dot(ray.direction);
     float b = 2.0f * oc.dot(ray.direction);
@@ -222,11 +318,18 @@ bool intersectSphere(const Ray& ray, const Vector3& center, float radius, HitRec
 
     if (discriminant < 0) return false;
 
-    float t = (-b - sqrt(discriminant)) / (2.0f * a);
+    t = (-b - sqrt(discriminant)) / (2.0f * a);
     if (t < 0.001f) {
         t = (-b + sqrt(discriminant)) / (2.0f * a);
         if (t < 0.001f) return false;
     }
+    return true;
+}
+
+// Função de interseção com esfera
+bool intersectSphere(const Ray& ray, const Vector3& center, float radius, HitRecord& rec) {
+    float t;
+    if (!sphereDistance(ray, center, radius, t)) return false;
 
     if (t < rec.t) {
         rec.hit = true;
@@ -238,8 +341,8 @@ bool intersectSphere(const Ray& ray, const Vector3& center, float radius, HitRec
     return false;
 }
 
-// Função de interseção com cilindro (eixo Y)
-bool intersectCylinder(const Ray& ray, const Vector3& base, float radius, float height, HitRecord& rec) {
+// Distância até o cilindro (eixo Y), já respeitando a altura
+bool cylinderDistance(const Ray& ray, const Vector3& base, float radius, float height, float& t) {
     Vector3 d = ray.direction;
     Vector3 o = ray.origin - base;
 
@@ -250,14 +353,21 @@ bool intersectCylinder(const Ray& ray, const Vector3& base, float radius, float
     float discriminant = b * b - 4 * a * c;
     if (discriminant < 0) return false;
 
-    float t = (-b - sqrt(discriminant)) / (2.0f * a);
+    t = (-b - sqrt(discriminant)) / (2.0f * a);
     if (t < 0.001f) t = (-b + sqrt(discriminant)) / (2.0f * a);
     if (t < 0.001f) return false;
 
-    Vector3 point = ray.origin + ray.direction * t;
-    float y = point.y - base.y;
+    float y = (ray.origin.y + ray.direction.y * t) - base.y;
+    return y >= 0 && y <= height;
+}
+
+// Função de interseção com cilindro (eixo Y)
+bool intersectCylinder(const Ray& ray, const Vector3& base, float radius, float height, HitRecord& rec) {
+    float t;
+    if (!cylinderDistance(ray, base, radius, height, t)) return false;
 
-    if (y >= 0 && y <= height && t < rec.t) {
+    if (t < rec.t) {
+        Vector3 point = ray.origin + ray.direction * t;
         rec.hit = true;
         rec.t = t;
         rec.point = point;
@@ -268,8 +378,8 @@ bool intersectCylinder(const Ray& ray, const Vector3& base, float radius, float
     return false;
 }
 
-// Função de interseção com cone (eixo Y)
-bool intersectCone(const Ray& ray, const Vector3& apex, float baseRadius, float height, HitRecord& rec) {
+// Distância até o cone (eixo Y, ápice para cima), já respeitando a altura
+bool coneDistance(const Ray& ray, const Vector3& apex, float baseRadius, float height, float& t) {
     Vector3 d = ray.direction;
     Vector3 o = ray.origin - apex;
 
@@ -282,14 +392,21 @@ bool intersectCone(const Ray& ray, const Vector3& apex, float baseRadius, float
     float discriminant = b * b - 4 * a * c;
     if (discriminant < 0) return false;
 
-    float t = (-b - sqrt(discriminant)) / (2.0f * a);
+    t = (-b - sqrt(discriminant)) / (2.0f * a);
     if (t < 0.001f) t = (-b + sqrt(discriminant)) / (2.0f * a);
     if (t < 0.001f) return false;
 
-    Vector3 point = ray.origin + ray.direction * t;
-    float y = point.y - apex.y;
+    float y = (ray.origin.y + ray.direction.y * t) - apex.y;
+    return y <= 0 && y >= -height;
+}
+
+// Função de interseção com cone (eixo Y)
+bool intersectCone(const Ray& ray, const Vector3& apex, float baseRadius, float height, HitRecord& rec) {
+    float t;
+    if (!coneDistance(ray, apex, baseRadius, height, t)) return false;
 
-    if (y <= 0 && y >= -height && t < rec.t) {
+    if (t < rec.t) {
+        Vector3 point = ray.origin + ray.direction * t;
         rec.hit = true;
         rec.t = t;
         rec.point = point;
@@ -301,13 +418,19 @@ bool intersectCone(const Ray& ray, const Vector3& apex, float baseRadius, float
     return false;
 }
 
-// Função de interseção com plano (com UV)
-bool intersectPlane(const Ray& ray, const Vector3& point, const Vector3& normal, HitRecord& rec, float uvScale = 1.0f) {
+// Distância até o plano
+bool planeDistance(const Ray& ray, const Vector3& point, const Vector3& normal, float& t) {
     float denom = normal.dot(ray.direction);
     if (fabs(denom) < 0.0001f) return false;
 
-    float t = (point - ray.origin).dot(normal) / denom;
-    if (t < 0.001f || t >= rec.t) return false;
+    t = (point - ray.origin).dot(normal) / denom;
+    return t >= 0.001f;
+}
+
+// Função de interseção com plano (com UV)
+bool intersectPlane(const Ray& ray, const Vector3& point, const Vector3& normal, HitRecord& rec, float uvScale = 1.0f) {
+    float t;
+    if (!planeDistance(ray, point, normal, t) || t >= rec.t) return false;
 
     rec.hit = true;
     rec.t = t;
@@ -319,14 +442,20 @@ bool intersectPlane(const Ray& ray, const Vector3& point, const Vector3& normal,
         // Plano horizontal (chão/teto)
         rec.u = fmod(rec.point.x * uvScale, 1.0);
         rec.v = fmod(rec.point.z * uvScale, 1.0);
+        rec.dudP = Vector3(uvScale, 0, 0);
+        rec.dvdP = Vector3(0, 0, uvScale);
     } else if (fabs(normal.x) > 0.9f) {
         // Plano vertical (parede perpendicular a X)
         rec.u = fmod(rec.point.z * uvScale, 1.0);
         rec.v = fmod(rec.point.y * uvScale, 1.0);
+        rec.dudP = Vector3(0, 0, uvScale);
+        rec.dvdP = Vector3(0, uvScale, 0);
     } else {
         // Plano vertical (parede perpendicular a Z)
         rec.u = fmod(rec.point.x * uvScale, 1.0);
         rec.v = fmod(rec.point.y * uvScale, 1.0);
+        rec.dudP = Vector3(uvScale, 0, 0);
+        rec.dvdP = Vector3(0, uvScale, 0);
     }
 
     // Garante [0, 1]
@@ -336,29 +465,38 @@ bool intersectPlane(const Ray& ray, const Vector3& point, const Vector3& normal,
     return true;
 }
 
-// Função de interseção com caixa (AABB simplificado)
-bool intersectBox(const Ray& ray, const Vector3& min, const Vector3& max, HitRecord& rec) {
-    float tmin = (min.x - ray.origin.x) / ray.direction.x;
-    float tmax = (max.x - ray.origin.x) / ray.direction.x;
-    if (tmin > tmax) swap(tmin, tmax);
+// Distância de entrada na caixa (teste de slabs, sem normal/UV). O sinal
+// da direção escolhe a face de entrada de cada eixo, sem trocas
+bool boxDistance(const Ray& ray, const Vector3& min, const Vector3& max, float& t) {
+    const Vector3* bounds[2] = {&min, &max};
 
-    float tymin = (min.y - ray.origin.y) / ray.direction.y;
-    float tymax = (max.y - ray.origin.y) / ray.direction.y;
-    if (tymin > tymax) swap(tymin, tymax);
+    float tmin = (bounds[ray.sign[0]]->x - ray.origin.x) * ray.invDirection.x;
+    float tmax = (bounds[1 - ray.sign[0]]->x - ray.origin.x) * ray.invDirection.x;
+
+    float tymin = (bounds[ray.sign[1]]->y - ray.origin.y) * ray.invDirection.y;
+    float tymax = (bounds[1 - ray.sign[1]]->y - ray.origin.y) * ray.invDirection.y;
 
     if ((tmin > tymax) || (tymin > tmax)) return false;
     if (tymin > tmin) tmin = tymin;
     if (tymax < tmax) tmax = tymax;
 
-    float tzmin = (min.z - ray.origin.z) / ray.direction.z;
-    float tzmax = (max.z - ray.origin.z) / ray.direction.z;
-    if (tzmin > tzmax) swap(tzmin, tzmax);
+    float tzmin = (bounds[ray.sign[2]]->z - ray.origin.z) * ray.invDirection.z;
+    float tzmax = (bounds[1 - ray.sign[2]]->z - ray.origin.z) * ray.invDirection.z;
 
     if ((tmin > tzmax) || (tzmin > tmax)) return false;
     if (tzmin > tmin) tmin = tzmin;
     if (tzmax < tmax) tmax = tzmax;
 
-    if (tmin < 0.001f || tmin >= rec.t) return false;
+    if (tmin < 0.001f) return false;
+
+    t = tmin;
+    return true;
+}
+
+// Função de interseção com caixa (AABB simplificado)
+bool intersectBox(const Ray& ray, const Vector3& min, const Vector3& max, HitRecord& rec) {
+    float tmin;
+    if (!boxDistance(ray, min, max, tmin) || tmin >= rec.t) return false;
 
     rec.hit = true;
     rec.t = tmin;
@@ -382,291 +520,315 @@ bool intersectBox(const Ray& ray, const Vector3& min, const Vector3& max, HitRec
         // Face horizontal (top/bottom)
         rec.u = (rec.point.x - min.x) / size.x;
         rec.v = (rec.point.z - min.z) / size.z;
+        rec.dudP = Vector3(1.0 / size.x, 0, 0);
+        rec.dvdP = Vector3(0, 0, 1.0 / size.z);
     } else if (fabs(rec.normal.x) > 0.9f) {
         // Face lateral (left/right)
         rec.u = (rec.point.z - min.z) / size.z;
         rec.v = (rec.point.y - min.y) / size.y;
+        rec.dudP = Vector3(0, 0, 1.0 / size.z);
+        rec.dvdP = Vector3(0, 1.0 / size.y, 0);
     } else {
         // Face frontal/traseira
         rec.u = (rec.point.x - min.x) / size.x;
         rec.v = (rec.point.y - min.y) / size.y;
+        rec.dudP = Vector3(1.0 / size.x, 0, 0);
+        rec.dvdP = Vector3(0, 1.0 / size.y, 0);
     }
 
     return true;
 }
 
-// Verifica se um ponto está na sombra em relação a uma luz
-bool isInShadow(const Vector3& point, const Vector3& lightPos, const Vector3& normal) {
-    if (!ENABLE_SHADOWS) return false;
-
-    Vector3 toLight = lightPos - point;
-    float distanceToLight = toLight.length();
-    Vector3 lightDir = toLight.normalized();
-
-    // Cria raio de sombra com pequeno offset para evitar "shadow acne"
-    Ray shadowRay(point + normal * SHADOW_BIAS, lightDir);
-
-    // Testa interseção com objetos principais (altar, bancos, ostensório, vela)
-    HitRecord shadowHit;
-
-    // Altar
-    Vector3 baseMin(4.5, 0, 17.5);
-    Vector3 baseMax(7.5, 0.8, 18.5);
-    Vector3 altarCenter((baseMin.x + baseMax.x) * 0.5f,
-                       (baseMin.y + baseMax.y) * 0.5f,
-                       (baseMin.z + baseMax.z) * 0.5f);
-    Matrix4x4 transform = Matrix4x4::translation(altarTranslation) *
-                         Matrix4x4::translation(altarCenter) *
-                         Matrix4x4::rotationY(altarRotationY) *
-                         Matrix4x4::translation(altarCenter * -1.0f);
-    Vector3 altarMin = transform.transformPoint(baseMin);
-    Vector3 altarMax = transform.transformPoint(baseMax);
-    Vector3 realMin(min(altarMin.x, altarMax.x), min(altarMin.y, altarMax.y), min(altarMin.z, altarMax.z));
-    Vector3 realMax(max(altarMin.x, altarMax.x), max(altarMin.y, altarMax.y), max(altarMin.z, altarMax.z));
-
-    if (intersectBox(shadowRay, realMin, realMax, shadowHit)) {
-        if (shadowHit.t > 0.0f && shadowHit.t < distanceToLight) {
-            return true;
-        }
-    }
+// ============ CENA DA CAPELA (dados pré-construídos) ============
+// A geometria é montada uma única vez em buildChapelScene() e percorrida
+// pelos três caminhos (renderização, picking e sombras). Para adicionar um
+// objeto basta acrescentar uma entrada em chapelPrimitives.
+
+enum PrimitiveType {
+    PRIM_RECT,      // Plano limitado a um retângulo (opcionalmente com furo)
+    PRIM_BOX,       // Caixa alinhada aos eixos
+    PRIM_ORIENTED_BOX,  // Caixa em espaço local + transformação (ChapelTransform)
+    PRIM_SPHERE,
+    PRIM_CYLINDER,  // Eixo Y
+    PRIM_CONE       // Eixo Y, ápice para cima
+};
 
-    // Bancos
-    for (int i = 0; i < 4; i++) {
-        float z = 5 + i * 3.0f;
-        // Banco esquerdo
-        if (intersectBox(shadowRay, Vector3(1.3, 0, z - 0.25), Vector3(3.7, 0.45, z + 0.25), shadowHit)) {
-            if (shadowHit.t > 0.0f && shadowHit.t < distanceToLight) {
-                return true;
-            }
-        }
-        // Banco direito
-        if (intersectBox(shadowRay, Vector3(8.3, 0, z - 0.25), Vector3(10.7, 0.45, z + 0.25), shadowHit)) {
-            if (shadowHit.t > 0.0f && shadowHit.t < distanceToLight) {
-                return true;
-            }
-        }
-    }
+enum TextureId {
+    TEX_NONE = -1,
+    TEX_WOOD,
+    TEX_WALL,
+    TEX_STAINED_GLASS,
+    TEX_CEILING
+};
 
-    // Ostensório base
-    if (intersectCylinder(shadowRay, Vector3(6, 0.8, 18), 0.15f, 0.3f, shadowHit)) {
-        if (shadowHit.t > 0.0f && shadowHit.t < distanceToLight) {
-            return true;
-        }
-    }
+// Tudo o que o sombreamento precisa saber sobre a superfície
+struct ChapelMaterial {
+    Color color;
+    float shininess;
+    int textureId;
+    float emissive;       // Fator de auto-iluminação somado ao Phong
+    bool unlit;           // Só emissão (sem Phong): vitral, hóstia, chama
+};
 
-    // Ostensório hóstia
-    if (intersectSphere(shadowRay, Vector3(6, 1.4, 18), 0.14f, shadowHit)) {
-        if (shadowHit.t > 0.0f && shadowHit.t < distanceToLight) {
-            return true;
-        }
-    }
+// Transformação cacheada de um objeto: recalculada só quando os parâmetros
+// mudam, e lida por todos os raios do frame
+struct ChapelTransform {
+    Matrix4x4 localToWorld;
+    Matrix4x4 worldToLocal;
+    Matrix4x4 normalToWorld;  // Inversa transposta (normais)
+};
 
-    // Vela
-    if (intersectCylinder(shadowRay, Vector3(8, 0, 17.5), 0.12f, 1.0f, shadowHit)) {
-        if (shadowHit.t > 0.0f && shadowHit.t < distanceToLight) {
-            return true;
-        }
-    }
+struct ChapelPrimitive {
+    PrimitiveType type;
+    Vector3 p0;           // RECT: ponto do plano | BOX: min (local em ORIENTED_BOX) | demais: centro/base/ápice
+    Vector3 p1;           // RECT: normal         | BOX: max (local em ORIENTED_BOX)
+    float radius;
+    float height;
+    float uvScale;        // RECT: escala do UV planar
+    Vector3 boundsMin;    // RECT: limites do retângulo (eixo da normal = ±infinito)
+    Vector3 boundsMax;
+    bool hasHole;         // RECT: recorte (ex: porta na parede da frente)
+    Vector3 holeMin;
+    Vector3 holeMax;
+    bool stretchUV;       // RECT: uma única imagem esticada sobre o retângulo
+    int transformId;      // ORIENTED_BOX: índice em chapelTransforms
+    int materialId;
+    bool castsShadow;
+    bool visible;
+    string name;          // Usado só no picking
+
+    ChapelPrimitive()
+        : type(PRIM_BOX), radius(0), height(0), uvScale(1.0f), hasHole(false), stretchUV(false),
+          transformId(-1), materialId(0), castsShadow(false), visible(true) {}
+};
 
-    return false;
+vector<ChapelMaterial> chapelMaterials;
+vector<ChapelPrimitive> chapelPrimitives;
+vector<ChapelTransform> chapelTransforms;
+const Texture* chapelTextures[] = { &woodTexture, &wallTexture, &stainedGlassTexture, &ceilingTexture };
+
+// Índices de estado mutável (vela liga/desliga)
+int candleBodyIndex = -1;
+int candleFlameIndex = -1;
+int materialCandleLit = -1;
+int materialCandleUnlit = -1;
+
+// Transformação do altar e os parâmetros com que foi calculada
+int altarIndex = -1;
+Vector3 cachedAltarTranslation;
+float cachedAltarRotationY = 0.0f;
+
+int addChapelMaterial(const Color& color, float shininess, int textureId = TEX_NONE,
+                      float emissive = 0.0f, bool unlit = false) {
+    chapelMaterials.push_back({color, shininess, textureId, emissive, unlit});
+    return (int)chapelMaterials.size() - 1;
 }
 
-// Modelo de iluminação Phong (com suporte a texturas e sombras)
-Color phongShading(
-    const Vector3& point,
-    const Vector3& normal,
-    const Vector3& viewDir,
-    const Color& albedo,
-    float shininess,
-    const vector<Light>& lights,
-    const Color& ambient,
-    bool useTexture = false,
-    double u = 0,
-    double v = 0,
-    const Texture* texture = nullptr
-) {
-    // Cor base (textura ou cor sólida)
-    Color baseColor = albedo;
-    if (useTexture && texture && texture->isLoaded()) {
-        baseColor = texture->sample(u, v);
-    }
-
-    Color result = baseColor * ambient * 0.3f;
-
-    for (const auto& light : lights) {
-        if (!light.enabled) continue;
-
-        Vector3 lightDir = (light.position - point).normalized();
-
-        // Verifica se o ponto está na sombra em relação a esta luz
-        bool inShadow = isInShadow(point, light.position, normal);
-        float shadowFactor = inShadow ? SHADOW_INTENSITY : 1.0f;
-
-        // Componente difusa
-        float diff = fmax(0.0f, (float)normal.dot(lightDir));
-        Color diffuse = baseColor * light.intensity * diff * shadowFactor;
+// Textura do material (nullptr se não tiver ou se não carregou)
+const Texture* materialTexture(const ChapelMaterial& mat) {
+    if (mat.textureId == TEX_NONE) return nullptr;
+    const Texture* texture = chapelTextures[mat.textureId];
+    return texture->isLoaded() ? texture : nullptr;
+}
 
-        // Componente especular
-        Vector3 reflectDir = normal * (2.0f * normal.dot(lightDir)) - lightDir;
-        float spec = pow(fmax(0.0f, (float)viewDir.dot(reflectDir)), shininess);
-        Color specular = light.intensity * spec * 0.5f * shadowFactor;
+// Nome do objeto atingido (apenas para saída do picking)
+const string& chapelObjectName(int objectId) {
+    static const string none = "";
+    return objectId >= 0 ? chapelPrimitives[objectId].name : none;
+}
 
-        result = result + diffuse + specular;
-    }
+int addChapelPrimitive(const ChapelPrimitive& prim) {
+    chapelPrimitives.push_back(prim);
+    return (int)chapelPrimitives.size() - 1;
+}
 
-    return result;
+ChapelPrimitive makeRect(const Vector3& point, const Vector3& normal, float uvScale,
+                         const Vector3& boundsMin, const Vector3& boundsMax,
+                         int materialId, const string& name) {
+    ChapelPrimitive prim;
+    prim.type = PRIM_RECT;
+    prim.p0 = point;
+    prim.p1 = normal;
+    prim.uvScale = uvScale;
+    prim.boundsMin = boundsMin;
+    prim.boundsMax = boundsMax;
+    prim.materialId = materialId;
+    prim.name = name;
+    return prim;
 }
 
-// Função de picking - retorna o objeto mais próximo atingido por um raio
-HitRecord performPicking(const Ray& ray) {
-    HitRecord rec;
+ChapelPrimitive makeBox(const Vector3& min, const Vector3& max, int materialId, const string& name) {
+    ChapelPrimitive prim;
+    prim.type = PRIM_BOX;
+    prim.p0 = min;
+    prim.p1 = max;
+    prim.materialId = materialId;
+    prim.name = name;
+    return prim;
+}
 
-    // Chão (finito)
-    HitRecord floorRec;
-    if (intersectPlane(ray, Vector3(0, 0, 0), Vector3(0, 1, 0), floorRec, 0.5f)) {
-        Vector3 p = floorRec.point;
-        if (p.x >= 0.0f && p.x <= CHAPEL_WIDTH && p.z >= 0.0f && p.z <= CHAPEL_DEPTH) {
-            rec = floorRec;
-            rec.color = Color(0.6f, 0.5f, 0.4f);
-            rec.shininess = 5.0f;
-            rec.objectName = "Chao";
-        }
-    }
+ChapelPrimitive makeRound(PrimitiveType type, const Vector3& center, float radius, float height,
+                          int materialId, const string& name) {
+    ChapelPrimitive prim;
+    prim.type = type;
+    prim.p0 = center;
+    prim.radius = radius;
+    prim.height = height;
+    prim.materialId = materialId;
+    prim.name = name;
+    return prim;
+}
 
-    // Paredes (finitas)
-    HitRecord wallRec;
-    // Parede do fundo
-    if (intersectPlane(ray, Vector3(0, 0, 20), Vector3(0, 0, 1), wallRec, 0.25f)) {
-        Vector3 p = wallRec.point;
-        if (p.x >= 0.0f && p.x <= CHAPEL_WIDTH && p.y >= 0.0f && p.y <= CHAPEL_HEIGHT) {
-            if (wallRec.t < rec.t) {
-                rec = wallRec;
-                rec.objectName = "Parede do Fundo";
-            }
-        }
-    }
-    // Parede esquerda
-    if (intersectPlane(ray, Vector3(0, 0, 0), Vector3(1, 0, 0), wallRec, 0.25f)) {
-        Vector3 p = wallRec.point;
-        if (p.z >= 0.0f && p.z <= CHAPEL_DEPTH && p.y >= 0.0f && p.y <= CHAPEL_HEIGHT) {
-            if (wallRec.t < rec.t) {
-                rec = wallRec;
-                rec.objectName = "Parede Esquerda";
-            }
-        }
-    }
-    // Parede direita
-    if (intersectPlane(ray, Vector3(12, 0, 0), Vector3(1, 0, 0), wallRec, 0.25f)) {
-        Vector3 p = wallRec.point;
-        if (p.z >= 0.0f && p.z <= CHAPEL_DEPTH && p.y >= 0.0f && p.y <= CHAPEL_HEIGHT) {
-            if (wallRec.t < rec.t) {
-                rec = wallRec;
-                rec.objectName = "Parede Direita";
-            }
-        }
-    }
-    // Parede frontal (com porta)
-    if (intersectPlane(ray, Vector3(0, 0, 0), Vector3(0, 0, 1), wallRec, 0.25f)) {
-        Vector3 p = wallRec.point;
-        bool isWall = (p.x >= 0.0f && p.x <= 12.0f && p.y >= 0.0f && p.y <= 8.0f);
-        bool isDoor = (p.x >= 4.0f && p.x <= 8.0f && p.y >= 0.0f && p.y <= 3.0f);
-        if (isWall && !isDoor) {
-            if (wallRec.t < rec.t) {
-                rec = wallRec;
-                rec.objectName = "Parede da Frente (Entrada)";
-            }
-        }
+// Recalcula a transformação do altar se altarTranslation/altarRotationY mudaram.
+// Chamada fora da renderização (antes de cada frame).
+void updateTransformCache(bool force = false) {
+    if (!force && cachedAltarTranslation.x == altarTranslation.x &&
+        cachedAltarTranslation.y == altarTranslation.y &&
+        cachedAltarTranslation.z == altarTranslation.z &&
+        cachedAltarRotationY == altarRotationY) {
+        return;
     }
 
-    // Janela de vitral
-    HitRecord glassRec;
-    if (intersectPlane(ray, Vector3(0, 0, 19.9f), Vector3(0, 0, 1), glassRec, 0.5f)) {
-        Vector3 p = glassRec.point;
-        if (p.x >= 4.5f && p.x <= 7.5f && p.y >= 2.0f && p.y <= 5.0f) {
-            if (glassRec.t < rec.t) {
-                rec = glassRec;
-                rec.objectName = "Janela de Vitral";
-            }
-        }
-    }
+    // Translação + rotação em torno do centro do altar (caixa local)
+    const ChapelPrimitive& altar = chapelPrimitives[altarIndex];
+    Vector3 altarCenter = (altar.p0 + altar.p1) * 0.5f;
 
-    // Teto (finito)
-    if (intersectPlane(ray, Vector3(0, 8, 0), Vector3(0, 1, 0), wallRec, 0.5f)) {
-        Vector3 p = wallRec.point;
-        if (p.x >= 0.0f && p.x <= CHAPEL_WIDTH && p.z >= 0.0f && p.z <= CHAPEL_DEPTH) {
-            if (wallRec.t < rec.t) {
-                rec = wallRec;
-                rec.objectName = "Teto";
-            }
-        }
-    }
+    ChapelTransform& xf = chapelTransforms[altar.transformId];
+    xf.localToWorld = Matrix4x4::translation(altarTranslation) *
+                      Matrix4x4::translation(altarCenter) *
+                      Matrix4x4::rotationY(altarRotationY) *
+                      Matrix4x4::translation(altarCenter * -1.0f);
+    xf.worldToLocal = xf.localToWorld.inverse();
+    xf.normalToWorld = xf.worldToLocal.transposed();
 
-    // Porta de entrada
-    HitRecord boxRec;
-    if (intersectBox(ray, Vector3(4.0, 0, 0.05), Vector3(8.0, 3.0, 0.15), boxRec)) {
-        if (boxRec.t < rec.t) {
-            rec = boxRec;
-            rec.objectName = "Porta de Entrada";
-        }
-    }
+    cachedAltarTranslation = altarTranslation;
+    cachedAltarRotationY = altarRotationY;
+}
 
-    // Altar
-    if (intersectBox(ray, Vector3(4.5, 0, 17.5), Vector3(7.5, 0.8, 18.5), boxRec)) {
-        if (boxRec.t < rec.t) {
-            rec = boxRec;
-            rec.objectName = "Altar";
-        }
-    }
+// Atualiza os primitivos que dependem do estado da vela
+void updateCandleState() {
+    ChapelPrimitive& body = chapelPrimitives[candleBodyIndex];
+    body.materialId = candleLit ? materialCandleLit : materialCandleUnlit;
+    body.name = candleLit ? "Vela (Acesa)" : "Vela (Apagada)";
+    chapelPrimitives[candleFlameIndex].visible = candleLit;
+}
 
-    // Bancos
+void buildChapelScene() {
+    const float inf = numeric_limits<float>::infinity();
+    chapelMaterials.clear();
+    chapelPrimitives.clear();
+    chapelTransforms.clear();
+
+    // Materiais
+    int matFloor = addChapelMaterial(Color(0.6f, 0.5f, 0.4f), 5.0f, TEX_NONE, EMISSIVE_FLOOR);
+    int matWall = addChapelMaterial(Color(0.7f, 0.68f, 0.65f), 5.0f, TEX_WALL, EMISSIVE_WALLS);
+    int matGlass = addChapelMaterial(Color(1.2f, 1.2f, 1.5f), 100.0f,     // Cor base mais brilhante
+                                     TEX_STAINED_GLASS, EMISSIVE_VITRAL, true);
+    int matCeiling = addChapelMaterial(Color(0.65f, 0.63f, 0.60f), 5.0f, TEX_CEILING, EMISSIVE_CEILING);
+    int matDoor = addChapelMaterial(Color(0.5f, 0.35f, 0.2f), 15.0f, TEX_WOOD);     // Madeira escura
+    int matWood = addChapelMaterial(Color(0.6f, 0.4f, 0.2f), 10.0f, TEX_WOOD);
+    int matGold = addChapelMaterial(Color(0.9f, 0.75f, 0.3f), 50.0f);     // Dourado
+    int matHost = addChapelMaterial(Color(1.0f, 1.0f, 0.95f), 100.0f,    // Branco brilhante
+                                    TEX_NONE, EMISSIVE_HOSTIA, true);
+    int matGoldBright = addChapelMaterial(Color(0.95f, 0.85f, 0.4f), 60.0f);
+    materialCandleLit = addChapelMaterial(Color(0.8f, 0.2f, 0.15f), 10.0f);    // Vermelha
+    materialCandleUnlit = addChapelMaterial(Color(0.3f, 0.3f, 0.3f), 10.0f);   // Cinza (apagada)
+    int matFlame = addChapelMaterial(Color(1.0f, 0.8f, 0.0f), 5.0f,      // Amarela
+                                     TEX_NONE, EMISSIVE_CANDLE, true);
+
+    // Chão (finito - dentro da capela)
+    ChapelPrimitive floor = makeRect(Vector3(0, 0, 0), Vector3(0, 1, 0), 0.5f,
+                                     Vector3(0, -inf, 0), Vector3(CHAPEL_WIDTH, inf, CHAPEL_DEPTH),
+                                     matFloor, "Chao");
+    addChapelPrimitive(floor);
+
+    // Paredes (com textura) - finitas
+    ChapelPrimitive wall = makeRect(Vector3(0, 0, 20), Vector3(0, 0, 1), 0.25f,
+                                    Vector3(0, 0, -inf), Vector3(CHAPEL_WIDTH, CHAPEL_HEIGHT, inf),
+                                    matWall, "Parede do Fundo");
+    addChapelPrimitive(wall);
+
+    wall.p0 = Vector3(0, 0, 0);
+    wall.p1 = Vector3(1, 0, 0);
+    wall.boundsMin = Vector3(-inf, 0, 0);
+    wall.boundsMax = Vector3(inf, CHAPEL_HEIGHT, CHAPEL_DEPTH);
+    wall.name = "Parede Esquerda";
+    addChapelPrimitive(wall);
+
+    wall.p0 = Vector3(12, 0, 0);
+    wall.name = "Parede Direita";
+    addChapelPrimitive(wall);
+
+    // Parede frontal com a porta: X=[4,8], Y=[0,3] (entrada central)
+    wall.p0 = Vector3(0, 0, 0);
+    wall.p1 = Vector3(0, 0, 1);
+    wall.boundsMin = Vector3(0, 0, -inf);
+    wall.boundsMax = Vector3(CHAPEL_WIDTH, CHAPEL_HEIGHT, inf);
+    wall.hasHole = true;
+    wall.holeMin = Vector3(4.0f, 0.0f, -inf);
+    wall.holeMax = Vector3(8.0f, 3.0f, inf);
+    wall.name = "Parede da Frente (Entrada)";
+    addChapelPrimitive(wall);
+
+    // Janela de vitral atrás do ostensório (emissiva/brilhante)
+    ChapelPrimitive glass = makeRect(Vector3(0, 0, 19.9f), Vector3(0, 0, 1), 0.5f,
+                                     Vector3(4.5f, 2.0f, -inf), Vector3(7.5f, 5.0f, inf),
+                                     matGlass, "Janela de Vitral");
+    glass.stretchUV = true;
+    addChapelPrimitive(glass);
+
+    // Teto (uma única imagem para todo o teto)
+    ChapelPrimitive ceiling = makeRect(Vector3(0, 8, 0), Vector3(0, 1, 0), 1.0f,
+                                       Vector3(0, -inf, 0), Vector3(CHAPEL_WIDTH, inf, CHAPEL_DEPTH),
+                                       matCeiling, "Teto");
+    ceiling.stretchUV = true;
+    addChapelPrimitive(ceiling);
+
+    // Porta de entrada (caixa com textura de madeira)
+    addChapelPrimitive(makeBox(Vector3(4.0, 0, 0.05), Vector3(8.0, 3.0, 0.15), matDoor, "Porta de Entrada"));
+
+    // Altar - COM TRANSFORMAÇÕES: caixa orientada (p0/p1 em espaço local)
+    // cuja matriz é mantida por updateTransformCache()
+    ChapelPrimitive altar = makeBox(Vector3(4.5, 0, 17.5), Vector3(7.5, 0.8, 18.5), matWood, "Altar");
+    altar.type = PRIM_ORIENTED_BOX;
+    altar.transformId = (int)chapelTransforms.size();
+    altar.castsShadow = true;
+    chapelTransforms.push_back(ChapelTransform());
+    altarIndex = addChapelPrimitive(altar);
+
+    // Bancos (com textura de madeira)
     for (int i = 0; i < 4; i++) {
         float z = 5 + i * 3.0f;
-        if (intersectBox(ray, Vector3(1.3, 0, z - 0.25), Vector3(3.7, 0.45, z + 0.25), boxRec)) {
-            if (boxRec.t < rec.t) {
-                rec = boxRec;
-                rec.objectName = "Banco Esquerdo " + to_string(i + 1);
-            }
-        }
-        if (intersectBox(ray, Vector3(8.3, 0, z - 0.25), Vector3(10.7, 0.45, z + 0.25), boxRec)) {
-            if (boxRec.t < rec.t) {
-                rec = boxRec;
-                rec.objectName = "Banco Direito " + to_string(i + 1);
-            }
-        }
+        ChapelPrimitive bench = makeBox(Vector3(1.3, 0, z - 0.25), Vector3(3.7, 0.45, z + 0.25),
+                                        matWood, "Banco Esquerdo " + to_string(i + 1));
+        bench.castsShadow = true;
+        addChapelPrimitive(bench);
+
+        bench.p0 = Vector3(8.3, 0, z - 0.25);
+        bench.p1 = Vector3(10.7, 0.45, z + 0.25);
+        bench.name = "Banco Direito " + to_string(i + 1);
+        addChapelPrimitive(bench);
     }
 
-    // Ostensório
-    HitRecord cylRec;
-    if (intersectCylinder(ray, Vector3(6, 0.8, 18), 0.15f, 0.3f, cylRec)) {
-        if (cylRec.t < rec.t) {
-            rec = cylRec;
-            rec.objectName = "Ostensorio - Base";
-        }
-    }
+    // Ostensório: base (cilindro) e hóstia (esfera emissiva)
+    ChapelPrimitive monstranceBase = makeRound(PRIM_CYLINDER, Vector3(6, 0.8, 18), 0.15f, 0.3f, matGold, "Ostensorio - Base");
+    monstranceBase.castsShadow = true;
+    addChapelPrimitive(monstranceBase);
 
-    HitRecord sphereRec;
-    if (intersectSphere(ray, Vector3(6, 1.4, 18), 0.14f, sphereRec)) {
-        if (sphereRec.t < rec.t) {
-            rec = sphereRec;
-            rec.objectName = "Ostensorio - Hostia";
-        }
-    }
+    ChapelPrimitive host = makeRound(PRIM_SPHERE, Vector3(6, 1.4, 18), 0.14f, 0.0f, matHost, "Ostensorio - Hostia");
+    host.castsShadow = true;
+    addChapelPrimitive(host);
 
-    // Raios do ostensório
+    // Raios do ostensório: esfera na ponta + conector (caixa fina) que não toca a hóstia
     for (int i = 0; i < 8; i++) {
         float angle = i * 2 * M_PI / 8;
         float offsetX = 0.25f * cos(angle);
         float offsetY = 0.25f * sin(angle);
 
-        // Esfera na ponta
-        if (intersectSphere(ray, Vector3(6 + offsetX, 1.4 + offsetY, 18), 0.025f, sphereRec)) {
-            if (sphereRec.t < rec.t) {
-                rec = sphereRec;
-                rec.objectName = "Ostensorio - Raio";
-            }
-        }
+        addChapelPrimitive(makeRound(PRIM_SPHERE, Vector3(6 + offsetX, 1.4 + offsetY, 18), 0.025f, 0.0f,
+                                     matGold, "Ostensorio - Raio"));
 
-        // Conector (linha dourada)
+        // Começa a 0.16 da hóstia (raio 0.14 + folga) e termina em 0.225 (antes da esfera a 0.25)
         float startDist = 0.16f;
         float endDist = 0.225f;
 
@@ -678,6 +840,7 @@ HitRecord performPicking(const Ray& ray) {
         Vector3 boxMin(rayMid.x - 0.008f, rayMid.y - 0.008f, 17.98f);
         Vector3 boxMax(rayMid.x + 0.008f, rayMid.y + 0.008f, 18.02f);
 
+        // Ajusta dimensões baseado no ângulo
         if (fabs(cos(angle)) > fabs(sin(angle))) {
             boxMin.x = rayStart.x;
             boxMax.x = rayEnd.x;
@@ -686,423 +849,287 @@ HitRecord performPicking(const Ray& ray) {
             boxMax.y = rayEnd.y;
         }
 
-        if (intersectBox(ray, boxMin, boxMax, boxRec)) {
-            if (boxRec.t < rec.t) {
-                rec = boxRec;
-                rec.objectName = "Ostensorio - Raio Conector";
-            }
-        }
+        addChapelPrimitive(makeBox(boxMin, boxMax, matGoldBright, "Ostensorio - Raio Conector"));
     }
 
-    // Vela
-    if (intersectCylinder(ray, Vector3(8, 0, 17.5), 0.12f, 1.0f, cylRec)) {
-        if (cylRec.t < rec.t) {
-            rec = cylRec;
-            rec.objectName = candleLit ? "Vela (Acesa)" : "Vela (Apagada)";
-        }
-    }
+    // Vela (cilindro) e chama (cone, só quando acesa)
+    ChapelPrimitive candle = makeRound(PRIM_CYLINDER, Vector3(8, 0, 17.5), 0.12f, 1.0f, materialCandleLit, "Vela (Acesa)");
+    candle.castsShadow = true;
+    candleBodyIndex = addChapelPrimitive(candle);
 
-    // Chama da vela
-    if (candleLit) {
-        HitRecord coneRec;
-        if (intersectCone(ray, Vector3(8, 1.3, 17.5), 0.08f, 0.3f, coneRec)) {
-            if (coneRec.t < rec.t) {
-                rec = coneRec;
-                rec.objectName = "Chama da Vela";
-            }
-        }
-    }
+    ChapelPrimitive flame = makeRound(PRIM_CONE, Vector3(8, 1.3, 17.5), 0.08f, 0.3f, matFlame, "Chama da Vela");
+    candleFlameIndex = addChapelPrimitive(flame);
 
-    return rec;
+    updateCandleState();
+    updateTransformCache(true);
 }
 
-// Renderiza a cena para um tile
-void renderTile(
-    int startY, int endY,
-    int width, int height,
-    vector<Color>& framebuffer,
-    const Camera& camera,
-    const vector<Light>& lights,
-    const Color& ambient
-) {
-    float aspectRatio = (float)width / (float)height;
+// Ponto (já no plano) dentro do retângulo e fora do recorte?
+bool rectContains(const ChapelPrimitive& prim, const Vector3& p) {
+    if (p.x < prim.boundsMin.x || p.x > prim.boundsMax.x ||
+        p.y < prim.boundsMin.y || p.y > prim.boundsMax.y ||
+        p.z < prim.boundsMin.z || p.z > prim.boundsMax.z) return false;
 
-    for (int y = startY; y < endY; y++) {
-        for (int x = 0; x < width; x++) {
-            float px = (2.0f * x / width - 1.0f);
-            float py = (1.0f - 2.0f * y / height);
+    if (prim.hasHole &&
+        p.x >= prim.holeMin.x && p.x <= prim.holeMax.x &&
+        p.y >= prim.holeMin.y && p.y <= prim.holeMax.y &&
+        p.z >= prim.holeMin.z && p.z <= prim.holeMax.z) return false;
 
-            Ray ray = camera.generateRay(px, py, aspectRatio);
-            HitRecord rec;
-            Color pixelColor = Color(0.3f, 0.35f, 0.4f); // Background
+    return true;
+}
 
-            // Chão (finito - dentro da capela)
-            HitRecord floorRec;
-            if (intersectPlane(ray, Vector3(0, 0, 0), Vector3(0, 1, 0), floorRec, 0.5f)) {
-                Vector3 p = floorRec.point;
-                // Limita o chão às dimensões da capela
-                if (p.x >= 0.0f && p.x <= CHAPEL_WIDTH && p.z >= 0.0f && p.z <= CHAPEL_DEPTH) {
-                    rec = floorRec;
-                    rec.color = Color(0.6f, 0.5f, 0.4f);
-                    rec.shininess = 5.0f;
-                    rec.objectName = "Chao";
-                }
-            }
+// Raio em espaço local de uma caixa orientada; sem normalizar a direção,
+// o parâmetro t é o mesmo nos dois espaços
+Ray toLocalRay(const Ray& ray, const ChapelTransform& xf) {
+    return Ray(xf.worldToLocal.transformPoint(ray.origin),
+               xf.worldToLocal.transformDirection(ray.direction), RayDirection::UNIT);
+}
 
-            // Parede do fundo (com textura) - finita
-            HitRecord wallRec;
-            if (intersectPlane(ray, Vector3(0, 0, 20), Vector3(0, 0, 1), wallRec, 0.25f)) {
-                Vector3 p = wallRec.point;
-                // Limita a parede: X=[0,12], Y=[0,8]
-                if (p.x >= 0.0f && p.x <= CHAPEL_WIDTH && p.y >= 0.0f && p.y <= CHAPEL_HEIGHT) {
-                    if (wallRec.t < rec.t) {
-                        rec = wallRec;
-                        rec.color = Color(0.7f, 0.68f, 0.65f);
-                        rec.shininess = 5.0f;
-                        rec.useTexture = true;
-                        rec.texture = &wallTexture;
-                        rec.objectName = "Parede do Fundo";
-                    }
+// Testa um primitivo; aceita apenas acertos mais próximos que rec.t
+bool intersectPrimitive(const Ray& ray, const ChapelPrimitive& prim, HitRecord& rec) {
+    HitRecord tmp;
+    tmp.t = rec.t;
+
+    switch (prim.type) {
+        case PRIM_RECT: {
+            if (!intersectPlane(ray, prim.p0, prim.p1, tmp, prim.uvScale)) return false;
+
+            const Vector3& p = tmp.point;
+            if (!rectContains(prim, p)) return false;
+
+            if (prim.stretchUV) {
+                // Eixos do plano na mesma convenção de intersectPlane
+                Vector3 size = prim.boundsMax - prim.boundsMin;
+                if (fabs(prim.p1.y) > 0.9f) {
+                    tmp.u = (p.x - prim.boundsMin.x) / (prim.boundsMax.x - prim.boundsMin.x);
+                    tmp.v = (p.z - prim.boundsMin.z) / (prim.boundsMax.z - prim.boundsMin.z);
+                    tmp.dudP = Vector3(1.0 / size.x, 0, 0);
+                    tmp.dvdP = Vector3(0, 0, 1.0 / size.z);
+                } else if (fabs(prim.p1.x) > 0.9f) {
+                    tmp.u = (p.z - prim.boundsMin.z) / (prim.boundsMax.z - prim.boundsMin.z);
+                    tmp.v = (p.y - prim.boundsMin.y) / (prim.boundsMax.y - prim.boundsMin.y);
+                    tmp.dudP = Vector3(0, 0, 1.0 / size.z);
+                    tmp.dvdP = Vector3(0, 1.0 / size.y, 0);
+                } else {
+                    tmp.u = (p.x - prim.boundsMin.x) / (prim.boundsMax.x - prim.boundsMin.x);
+                    tmp.v = (p.y - prim.boundsMin.y) / (prim.boundsMax.y - prim.boundsMin.y);
+                    tmp.dudP = Vector3(1.0 / size.x, 0, 0);
+                    tmp.dvdP = Vector3(0, 1.0 / size.y, 0);
                 }
             }
+            break;
+        }
+        case PRIM_BOX:
+            if (!intersectBox(ray, prim.p0, prim.p1, tmp)) return false;
+            break;
+        case PRIM_ORIENTED_BOX: {
+            const ChapelTransform& xf = chapelTransforms[prim.transformId];
+            if (!intersectBox(toLocalRay(ray, xf), prim.p0, prim.p1, tmp)) return false;
+
+            // UV fica em espaço local (textura acompanha a rotação); o
+            // gradiente do UV volta ao mundo pela transposta de worldToLocal
+            tmp.point = ray.origin + ray.direction * tmp.t;
+            tmp.normal = xf.normalToWorld.transformDirection(tmp.normal).normalized();
+            tmp.dudP = xf.normalToWorld.transformDirection(tmp.dudP);
+            tmp.dvdP = xf.normalToWorld.transformDirection(tmp.dvdP);
+            break;
+        }
+        case PRIM_SPHERE:
+            if (!intersectSphere(ray, prim.p0, prim.radius, tmp)) return false;
+            break;
+        case PRIM_CYLINDER:
+            if (!intersectCylinder(ray, prim.p0, prim.radius, prim.height, tmp)) return false;
+            break;
+        case PRIM_CONE:
+            if (!intersectCone(ray, prim.p0, prim.radius, prim.height, tmp)) return false;
+            break;
+    }
 
-            // Parede esquerda (com textura) - finita
-            if (intersectPlane(ray, Vector3(0, 0, 0), Vector3(1, 0, 0), wallRec, 0.25f)) {
-                Vector3 p = wallRec.point;
-                // Limita a parede: Z=[0,20], Y=[0,8]
-                if (p.z >= 0.0f && p.z <= CHAPEL_DEPTH && p.y >= 0.0f && p.y <= CHAPEL_HEIGHT) {
-                    if (wallRec.t < rec.t) {
-                        rec = wallRec;
-                        rec.color = Color(0.7f, 0.68f, 0.65f);
-                        rec.shininess = 5.0f;
-                        rec.useTexture = true;
-                        rec.texture = &wallTexture;
-                        rec.objectName = "Parede Esquerda";
-                    }
-                }
-            }
+    rec = tmp;
+    return true;
+}
 
-            // Parede direita (com textura) - finita
-            if (intersectPlane(ray, Vector3(12, 0, 0), Vector3(1, 0, 0), wallRec, 0.25f)) {
-                Vector3 p = wallRec.point;
-                // Limita a parede: Z=[0,20], Y=[0,8]
-                if (p.z >= 0.0f && p.z <= CHAPEL_DEPTH && p.y >= 0.0f && p.y <= CHAPEL_HEIGHT) {
-                    if (wallRec.t < rec.t) {
-                        rec = wallRec;
-                        rec.color = Color(0.7f, 0.68f, 0.65f);
-                        rec.shininess = 5.0f;
-                        rec.useTexture = true;
-                        rec.texture = &wallTexture;
-                        rec.objectName = "Parede Direita";
-                    }
-                }
-            }
+// Percorre a cena e devolve o acerto mais próximo (índices de objeto e material)
+HitRecord traceChapel(const Ray& ray) {
+    HitRecord rec;
 
-            // Parede frontal (com porta) - com textura
-            if (intersectPlane(ray, Vector3(0, 0, 0), Vector3(0, 0, 1), wallRec, 0.25f)) {
-                Vector3 p = wallRec.point;
-                // Parede frontal: X=[0,12], Y=[0,8]
-                // Porta: X=[4,8], Y=[0,3] (entrada central)
-                bool isWall = (p.x >= 0.0f && p.x <= CHAPEL_WIDTH && p.y >= 0.0f && p.y <= CHAPEL_HEIGHT);
-                bool isDoor = (p.x >= 4.0f && p.x <= 8.0f && p.y >= 0.0f && p.y <= 3.0f);
-
-                if (isWall && !isDoor) {
-                    if (wallRec.t < rec.t) {
-                        rec = wallRec;
-                        rec.color = Color(0.7f, 0.68f, 0.65f);
-                        rec.shininess = 5.0f;
-                        rec.useTexture = true;
-                        rec.texture = &wallTexture;
-                        rec.objectName = "Parede da Frente (Entrada)";
-                    }
-                }
-            }
+    for (size_t i = 0; i < chapelPrimitives.size(); i++) {
+        const ChapelPrimitive& prim = chapelPrimitives[i];
+        if (!prim.visible) continue;
+        if (intersectPrimitive(ray, prim, rec)) {
+            rec.objectId = (int)i;
+            rec.materialId = prim.materialId;
+        }
+    }
 
-            // Janela de vitral atrás do ostensório (emissiva/brilhante)
-            HitRecord glassRec;
-            if (intersectPlane(ray, Vector3(0, 0, 19.9f), Vector3(0, 0, 1), glassRec, 0.5f)) {
-                Vector3 p = glassRec.point;
-                // Limitar a janela a uma área específica atrás do ostensório
-                if (p.x >= 4.5f && p.x <= 7.5f && p.y >= 2.0f && p.y <= 5.0f) {
-                    if (glassRec.t < rec.t) {
-                        rec = glassRec;
-                        rec.color = Color(1.2f, 1.2f, 1.5f); // Cor base mais brilhante
-                        rec.shininess = 100.0f;
-                        rec.useTexture = true;
-                        rec.texture = &stainedGlassTexture;
-                        rec.objectName = "Janela de Vitral";
-                        // Ajusta UV para a janela
-                        rec.u = (p.x - 4.5f) / 3.0f;
-                        rec.v = (p.y - 2.0f) / 3.0f;
-                    }
-                }
-            }
+    return rec;
+}
 
-            // Teto (finito com textura - uma única imagem para todo o teto)
-            if (intersectPlane(ray, Vector3(0, 8, 0), Vector3(0, 1, 0), wallRec, 1.0f)) {
-                Vector3 p = wallRec.point;
-                // Limita o teto às dimensões da capela
-                if (p.x >= 0.0f && p.x <= CHAPEL_WIDTH && p.z >= 0.0f && p.z <= CHAPEL_DEPTH) {
-                    if (wallRec.t < rec.t) {
-                        rec = wallRec;
-                        rec.color = Color(0.65f, 0.63f, 0.60f);
-                        rec.shininess = 5.0f;
-                        rec.useTexture = true;
-                        rec.texture = &ceilingTexture;
-                        rec.objectName = "Teto";
-                        // Mapeia UMA ÚNICA imagem para todo o teto (0-1 em ambos os eixos)
-                        rec.u = p.x / CHAPEL_WIDTH;   // 0 a 1 ao longo da largura
-                        rec.v = p.z / CHAPEL_DEPTH;   // 0 a 1 ao longo do comprimento
-                    }
-                }
-            }
+// Consulta any-hit: existe bloqueio em (0.001, tMax)? Só distâncias,
+// sem ponto, normal ou UV
+bool occludedPrimitive(const Ray& ray, const ChapelPrimitive& prim, float tMax) {
+    float t;
 
-            // Porta de entrada (caixa com textura de madeira)
-            HitRecord boxRec;
-            if (intersectBox(ray, Vector3(4.0, 0, 0.05), Vector3(8.0, 3.0, 0.15), boxRec)) {
-                if (boxRec.t < rec.t) {
-                    rec = boxRec;
-                    rec.color = Color(0.5f, 0.35f, 0.2f); // Madeira escura
-                    rec.shininess = 15.0f;
-                    rec.useTexture = true;
-                    rec.texture = &woodTexture;
-                    rec.objectName = "Porta de Entrada";
-                }
-            }
+    switch (prim.type) {
+        case PRIM_RECT:
+            return planeDistance(ray, prim.p0, prim.p1, t) && t < tMax &&
+                   rectContains(prim, ray.origin + ray.direction * t);
+        case PRIM_BOX:
+            return boxDistance(ray, prim.p0, prim.p1, t) && t < tMax;
+        case PRIM_ORIENTED_BOX:
+            return boxDistance(toLocalRay(ray, chapelTransforms[prim.transformId]), prim.p0, prim.p1, t) &&
+                   t < tMax;
+        case PRIM_SPHERE:
+            return sphereDistance(ray, prim.p0, prim.radius, t) && t < tMax;
+        case PRIM_CYLINDER:
+            return cylinderDistance(ray, prim.p0, prim.radius, prim.height, t) && t < tMax;
+        case PRIM_CONE:
+            return coneDistance(ray, prim.p0, prim.radius, prim.height, t) && t < tMax;
+    }
+    return false;
+}
 
-            // Altar (caixa com textura de madeira) - COM TRANSFORMAÇÕES
-            {
-                // Posição original do altar
-                Vector3 baseMin(4.5, 0, 17.5);
-                Vector3 baseMax(7.5, 0.8, 18.5);
-                Vector3 altarCenter((baseMin.x + baseMax.x) * 0.5f,
-                                   (baseMin.y + baseMax.y) * 0.5f,
-                                   (baseMin.z + baseMax.z) * 0.5f);
-
-                // Aplica transformações: translação + rotação em torno do centro
-                Matrix4x4 transform = Matrix4x4::translation(altarTranslation) *
-                                     Matrix4x4::translation(altarCenter) *
-                                     Matrix4x4::rotationY(altarRotationY) *
-                                     Matrix4x4::translation(altarCenter * -1.0f);
-
-                // Transforma os vértices do altar
-                Vector3 altarMin = transform.transformPoint(baseMin);
-                Vector3 altarMax = transform.transformPoint(baseMax);
-
-                // Corrige ordem min/max após rotação
-                Vector3 realMin(min(altarMin.x, altarMax.x), min(altarMin.y, altarMax.y), min(altarMin.z, altarMax.z));
-                Vector3 realMax(max(altarMin.x, altarMax.x), max(altarMin.y, altarMax.y), max(altarMin.z, altarMax.z));
-
-                if (intersectBox(ray, realMin, realMax, boxRec)) {
-                    if (boxRec.t < rec.t) {
-                        rec = boxRec;
-                        rec.color = Color(0.6f, 0.4f, 0.2f);
-                        rec.shininess = 10.0f;
-                        rec.useTexture = true;
-                        rec.texture = &woodTexture;
-                        rec.objectName = "Altar";
-                    }
-                }
-            }
+// Algum objeto que projeta sombra bloqueia o raio antes de tMax?
+// Retorna no primeiro bloqueio encontrado.
+bool chapelOccluded(const Ray& ray, float tMax) {
+    for (const auto& prim : chapelPrimitives) {
+        if (!prim.castsShadow || !prim.visible) continue;
+        if (occludedPrimitive(ray, prim, tMax)) return true;
+    }
+    return false;
+}
 
-            // Bancos (com textura de madeira)
-            for (int i = 0; i < 4; i++) {
-                float z = 5 + i * 3.0f;
-                // Banco esquerdo
-                if (intersectBox(ray, Vector3(1.3, 0, z - 0.25), Vector3(3.7, 0.45, z + 0.25), boxRec)) {
-                    if (boxRec.t < rec.t) {
-                        rec = boxRec;
-                        rec.color = Color(0.6f, 0.4f, 0.2f);
-                        rec.shininess = 10.0f;
-                        rec.useTexture = true;
-                        rec.texture = &woodTexture;
-                        rec.objectName = "Banco Esquerdo " + to_string(i + 1);
-                    }
-                }
-                // Banco direito
-                if (intersectBox(ray, Vector3(8.3, 0, z - 0.25), Vector3(10.7, 0.45, z + 0.25), boxRec)) {
-                    if (boxRec.t < rec.t) {
-                        rec = boxRec;
-                        rec.color = Color(0.6f, 0.4f, 0.2f);
-                        rec.shininess = 10.0f;
-                        rec.useTexture = true;
-                        rec.texture = &woodTexture;
-                        rec.objectName = "Banco Direito " + to_string(i + 1);
-                    }
-                }
-            }
+// Verifica se um ponto está na sombra em relação a uma luz
+bool isInShadow(const Vector3& point, const Vector3& lightPos, const Vector3& normal) {
+    if (!ENABLE_SHADOWS) return false;
 
-            // Ostensório base (cilindro)
-            HitRecord cylRec;
-            if (intersectCylinder(ray, Vector3(6, 0.8, 18), 0.15f, 0.3f, cylRec)) {
-                if (cylRec.t < rec.t) {
-                    rec = cylRec;
-                    rec.color = Color(0.9f, 0.75f, 0.3f); // Dourado
-                    rec.shininess = 50.0f;
-                    rec.objectName = "Ostensorio - Base";
-                }
-            }
+    Vector3 toLight = lightPos - point;
+    float distanceToLight = toLight.length();
+    Vector3 lightDir = toLight.normalized();
 
-            // Ostensório hóstia (esfera) - emissiva/brilhante
-            HitRecord sphereRec;
-            if (intersectSphere(ray, Vector3(6, 1.4, 18), 0.14f, sphereRec)) {
-                if (sphereRec.t < rec.t) {
-                    rec = sphereRec;
-                    rec.color = Color(1.0f, 1.0f, 0.95f); // Branco brilhante
-                    rec.shininess = 100.0f;
-                    rec.objectName = "Ostensorio - Hostia";
-                }
-            }
+    // Cria raio de sombra com pequeno offset para evitar "shadow acne"
+    Ray shadowRay(point + normal * SHADOW_BIAS, lightDir, RayDirection::UNIT);
 
-            // Raios do ostensório (esferas nas pontas)
-            for (int i = 0; i < 8; i++) {
-                float angle = i * 2 * M_PI / 8;
-                float offsetX = 0.25f * cos(angle);
-                float offsetY = 0.25f * sin(angle);
-
-                // Esfera na ponta do raio
-                if (intersectSphere(ray, Vector3(6 + offsetX, 1.4 + offsetY, 18), 0.025f, sphereRec)) {
-                    if (sphereRec.t < rec.t) {
-                        rec = sphereRec;
-                        rec.color = Color(0.9f, 0.75f, 0.3f);
-                        rec.shininess = 50.0f;
-                        rec.objectName = "Ostensorio - Raio";
-                    }
-                }
+    // Testa apenas os objetos que projetam sombra (altar, bancos, ostensório, vela)
+    return chapelOccluded(shadowRay, distanceToLight);
+}
 
-                // Linha/cilindro conectando a hóstia à esfera (não toca a hóstia)
-                // Começa a 0.16 da hóstia (raio da hóstia = 0.14 + pequeno gap = 0.16)
-                // Termina em 0.225 (perto da esfera que está a 0.25)
-                float startDist = 0.16f; // Começa logo após a hóstia
-                float endDist = 0.225f;  // Termina logo antes da esfera
+// Modelo de iluminação Phong (com suporte a texturas e sombras)
+Color phongShading(
+    const Vector3& point,
+    const Vector3& normal,
+    const Vector3& viewDir,
+    const Color& albedo,
+    float shininess,
+    const vector<Light>& lights,
+    const Color& ambient,
+    bool useTexture = false,
+    double u = 0,
+    double v = 0,
+    const Texture* texture = nullptr,
+    double lod = 0
+) {
+    // Cor base (textura ou cor sólida)
+    Color baseColor = albedo;
+    if (useTexture && texture && texture->isLoaded()) {
+        baseColor = texture->sample(u, v, lod);
+    }
 
-                Vector3 rayStart = Vector3(6 + startDist * cos(angle), 1.4 + startDist * sin(angle), 18);
-                Vector3 rayEnd = Vector3(6 + endDist * cos(angle), 1.4 + endDist * sin(angle), 18);
+    Color result = baseColor * ambient * 0.3f;
 
-                // Cria um cilindro fino conectando os pontos
-                // Vamos simular com uma caixa fina (box) orientada
-                Vector3 rayMid = Vector3(6 + (startDist + endDist) * 0.5f * cos(angle),
-                                        1.4 + (startDist + endDist) * 0.5f * sin(angle), 18);
+    for (const auto& light : lights) {
+        if (!light.enabled) continue;
 
-                // Caixa fina ao longo do raio
-                Vector3 boxMin(rayMid.x - 0.008f, rayMid.y - 0.008f, 17.98f);
-                Vector3 boxMax(rayMid.x + 0.008f, rayMid.y + 0.008f, 18.02f);
+        Vector3 lightDir = (light.position - point).normalized();
 
-                // Ajusta dimensões baseado no ângulo
-                if (fabs(cos(angle)) > fabs(sin(angle))) {
-                    boxMin.x = rayStart.x;
-                    boxMax.x = rayEnd.x;
-                } else {
-                    boxMin.y = rayStart.y;
-                    boxMax.y = rayEnd.y;
-                }
+        // Verifica se o ponto está na sombra em relação a esta luz
+        bool inShadow = isInShadow(point, light.position, normal);
+        float shadowFactor = inShadow ? SHADOW_INTENSITY : 1.0f;
 
-                if (intersectBox(ray, boxMin, boxMax, boxRec)) {
-                    if (boxRec.t < rec.t) {
-                        rec = boxRec;
-                        rec.color = Color(0.95f, 0.85f, 0.4f); // Dourado brilhante
-                        rec.shininess = 60.0f;
-                        rec.objectName = "Ostensorio - Raio Conector";
-                    }
-                }
-            }
+        // Componente difusa
+        float diff = fmax(0.0f, (float)normal.dot(lightDir));
+        Color diffuse = baseColor * light.intensity * diff * shadowFactor;
 
-            // Vela (cilindro)
-            if (intersectCylinder(ray, Vector3(8, 0, 17.5), 0.12f, 1.0f, cylRec)) {
-                if (cylRec.t < rec.t) {
-                    rec = cylRec;
-                    if (candleLit) {
-                        rec.color = Color(0.8f, 0.2f, 0.15f); // Vermelha
-                    } else {
-                        rec.color = Color(0.3f, 0.3f, 0.3f); // Cinza (apagada)
-                    }
-                    rec.shininess = 10.0f;
-                    rec.objectName = candleLit ? "Vela (Acesa)" : "Vela (Apagada)";
-                }
-            }
+        // Componente especular
+        Vector3 reflectDir = normal * (2.0f * normal.dot(lightDir)) - lightDir;
+        float spec = pow(fmax(0.0f, (float)viewDir.dot(reflectDir)), shininess);
+        Color specular = light.intensity * spec * 0.5f * shadowFactor;
 
-            // Chama da vela (cone) - só se acesa
-            if (candleLit) {
-                HitRecord coneRec;
-                if (intersectCone(ray, Vector3(8, 1.3, 17.5), 0.08f, 0.3f, coneRec)) {
-                    if (coneRec.t < rec.t) {
-                        rec = coneRec;
-                        rec.color = Color(1.0f, 0.8f, 0.0f); // Amarela
-                        rec.shininess = 5.0f;
-                        rec.objectName = "Chama da Vela";
-                    }
-                }
-            }
+        result = result + diffuse + specular;
+    }
+
+    return result;
+}
+
+// Nível de mip para o pé do pixel no ponto (dP/dx e dP/dy nas origens do
+// diferencial transferido): log2 da maior variação de UV entre pixels
+// vizinhos, medida em texels. Sem gradiente de UV, usa o nível 0.
+double textureLod(const Texture& texture, const HitRecord& rec, const RayDifferential& footprint) {
+    double width = texture.getWidth();
+    double height = texture.getHeight();
+    double dudx = rec.dudP.dot(footprint.dOdx) * width;
+    double dvdx = rec.dvdP.dot(footprint.dOdx) * height;
+    double dudy = rec.dudP.dot(footprint.dOdy) * width;
+    double dvdy = rec.dvdP.dot(footprint.dOdy) * height;
+
+    double rhoSquared = max(dudx * dudx + dvdx * dvdx, dudy * dudy + dvdy * dvdy);
+    if (rhoSquared <= 1.0) return 0.0;
+    return 0.5 * log2(rhoSquared);
+}
+
+// Função de picking - retorna o objeto mais próximo atingido por um raio
+HitRecord performPicking(const Ray& ray) {
+    return traceChapel(ray);
+}
+
+// Renderiza a cena para um tile [x0, x1) x [y0, y1); a câmera já preparou
+// os raios do quadro (Camera::prepareRays)
+void renderTile(
+    int x0, int y0, int x1, int y1,
+    Framebuffer& framebuffer,
+    const Camera& camera,
+    const vector<Light>& lights,
+    const Color& ambient
+) {
+    for (int y = y0; y < y1; y++) {
+        for (int x = x0; x < x1; x++) {
+            Ray ray = camera.primaryRay(x, y);
+            HitRecord rec = traceChapel(ray);
+            Color pixelColor = Color(0.3f, 0.35f, 0.4f); // Background
 
             // Se acertou algo, calcula iluminação
             if (rec.hit) {
-                // Objetos emissivos (brilham por conta própria)
-                if (rec.objectName == "Janela de Vitral") {
-                    // Vitral é emissivo com textura
-                    if (rec.useTexture && rec.texture && rec.texture->isLoaded()) {
-                        Color texColor = rec.texture->sample(rec.u, rec.v);
-                        pixelColor = texColor * EMISSIVE_VITRAL;
-                    } else {
-                        pixelColor = rec.color * EMISSIVE_VITRAL;
-                    }
-                } else if (rec.objectName == "Ostensorio - Hostia") {
-                    // Hóstia brilha intensamente (fonte de luz divina)
-                    pixelColor = rec.color * EMISSIVE_HOSTIA;
-                } else if (rec.objectName == "Chama da Vela") {
-                    // Chama da vela brilha
-                    pixelColor = rec.color * EMISSIVE_CANDLE;
-                } else if (rec.objectName == "Parede do Fundo" ||
-                           rec.objectName == "Parede Esquerda" ||
-                           rec.objectName == "Parede Direita" ||
-                           rec.objectName == "Parede da Frente (Entrada)") {
-                    // Paredes com emissão configurável
-                    Vector3 viewDir = (ray.origin - rec.point).normalized();
-                    Color litColor = phongShading(rec.point, rec.normal, viewDir,
-                                                 rec.color, rec.shininess, lights, ambient,
-                                                 rec.useTexture, rec.u, rec.v, rec.texture);
-
-                    if (rec.useTexture && rec.texture && rec.texture->isLoaded()) {
-                        Color texColor = rec.texture->sample(rec.u, rec.v);
-                        pixelColor = litColor + texColor * EMISSIVE_WALLS;
-                    } else {
-                        pixelColor = litColor + rec.color * EMISSIVE_WALLS;
-                    }
-                } else if (rec.objectName == "Teto") {
-                    // Teto com emissão configurável
-                    Vector3 viewDir = (ray.origin - rec.point).normalized();
-                    Color litColor = phongShading(rec.point, rec.normal, viewDir,
-                                                 rec.color, rec.shininess, lights, ambient,
-                                                 rec.useTexture, rec.u, rec.v, rec.texture);
-
-                    if (rec.useTexture && rec.texture && rec.texture->isLoaded()) {
-                        Color texColor = rec.texture->sample(rec.u, rec.v);
-                        pixelColor = litColor + texColor * EMISSIVE_CEILING;
-                    } else {
-                        pixelColor = litColor + rec.color * EMISSIVE_CEILING;
-                    }
-                } else if (rec.objectName == "Chao") {
-                    // Chão com emissão configurável
-                    Vector3 viewDir = (ray.origin - rec.point).normalized();
-                    Color litColor = phongShading(rec.point, rec.normal, viewDir,
-                                                 rec.color, rec.shininess, lights, ambient,
-                                                 rec.useTexture, rec.u, rec.v, rec.texture);
-
-                    if (rec.useTexture && rec.texture && rec.texture->isLoaded()) {
-                        Color texColor = rec.texture->sample(rec.u, rec.v);
-                        pixelColor = litColor + texColor * EMISSIVE_FLOOR;
-                    } else {
-                        pixelColor = litColor + rec.color * EMISSIVE_FLOOR;
-                    }
+                const ChapelMaterial& mat = chapelMaterials[rec.materialId];
+                const Texture* texture = materialTexture(mat);
+
+                // Área da textura coberta pelo pixel: diferenciais do raio
+                // primário levados ao plano tangente do acerto
+                double lod = 0.0;
+                if (texture) {
+                    RayDifferential footprint =
+                        camera.primaryDifferential(x, y).transfer(ray, rec.t, rec.normal);
+                    lod = textureLod(*texture, rec, footprint);
+                }
+
+                if (mat.unlit) {
+                    // Objetos emissivos (brilham por conta própria): vitral, hóstia, chama
+                    Color baseColor = texture ? texture->sample(rec.u, rec.v, lod) : mat.color;
+                    pixelColor = baseColor * mat.emissive;
                 } else {
-                    // Objetos normais - usa iluminação Phong
+                    // Iluminação Phong + emissão configurável (paredes, teto, chão)
                     Vector3 viewDir = (ray.origin - rec.point).normalized();
                     pixelColor = phongShading(rec.point, rec.normal, viewDir,
-                                             rec.color, rec.shininess, lights, ambient,
-                                             rec.useTexture, rec.u, rec.v, rec.texture);
+                                             mat.color, mat.shininess, lights, ambient,
+                                             texture != nullptr, rec.u, rec.v, texture, lod);
+
+                    if (mat.emissive > 0.0f) {
+                        Color baseColor = texture ? texture->sample(rec.u, rec.v, lod) : mat.color;
+                        pixelColor = pixelColor + baseColor * mat.emissive;
+                    }
                 }
             }
 
-            framebuffer[y * width + x] = pixelColor;
+            framebuffer.setPixel(x, y, pixelColor);
         }
     }
 }
@@ -1117,31 +1144,25 @@ int main() {
     cout << "  Mouse - Picking (clique na vela para ligar/desligar)" << endl;
     cout << "  ESC - Sair\n" << endl;
 
-    // Carregar texturas
-    cout << "Carregando texturas..." << endl;
-    if (!woodTexture.load("textures/wood.jpg")) {
-        cout << "  Aviso: Nao foi possivel carregar textura de madeira" << endl;
-    } else {
-        cout << "  ✓ Textura de madeira carregada" << endl;
-    }
-
-    if (!wallTexture.load("textures/wall.jpg")) {
-        cout << "  Aviso: Nao foi possivel carregar textura de parede" << endl;
-    } else {
-        cout << "  ✓ Textura de parede carregada" << endl;
-    }
-
-    if (!stainedGlassTexture.load("textures/stained_glass.jpg")) {
-        cout << "  Aviso: Nao foi possivel carregar textura de vitral" << endl;
-    } else {
-        cout << "  ✓ Textura de vitral carregada" << endl;
-    }
-
-    if (!ceilingTexture.load("textures/ceiling.jpg")) {
-        cout << "  Aviso: Nao foi possivel carregar textura do teto (ceiling.jpg)" << endl;
-    } else {
-        cout << "  ✓ Textura do teto carregada" << endl;
-    }
+    // Pool de threads persistente: criado uma vez, reutilizado a cada frame
+    // (e, no início, também decodifica as texturas)
+    ThreadPool renderPool(RENDER_THREADS);
+
+    // Texturas decodificadas em paralelo, em segundo plano: os primeiros
+    // quadros saem com a cor sólida dos materiais e cada textura entra
+    // assim que fica pronta (textureLoader.install() no laço principal)
+    cout << "Carregando texturas em segundo plano..." << endl;
+    auto loadStart = chrono::high_resolution_clock::now();
+    TextureLoader textureLoader(renderPool);
+    textureLoader.load("textures/wood.jpg", woodTexture);
+    textureLoader.load("textures/wall.jpg", wallTexture);
+    textureLoader.load("textures/stained_glass.jpg", stainedGlassTexture);
+    textureLoader.load("textures/ceiling.jpg", ceilingTexture);
+
+    // Monta a cena uma única vez
+    buildChapelScene();
+    cout << "Cena montada: " << chapelPrimitives.size() << " primitivos, "
+         << chapelMaterials.size() << " materiais" << endl;
 
     cout << "\nRenderizando na CPU (sem aceleração GPU)...\n" << endl;
 
@@ -1158,9 +1179,8 @@ int main() {
 
     SDL_GLContext context = SDL_GL_CreateContext(window);
 
-    // Framebuffer na CPU
-    vector<Color> framebuffer(WIDTH * HEIGHT);
-    vector<unsigned char> pixelBuffer(WIDTH * HEIGHT * 3);
+    // Framebuffer na CPU: RGBA8 com linhas alinhadas, enviado direto para a textura
+    Framebuffer framebuffer(WIDTH, HEIGHT, PixelFormat::RGBA8);
 
     // Criar textura OpenGL para display
     GLuint texture;
@@ -1168,7 +1188,7 @@ int main() {
     glBindTexture(GL_TEXTURE_2D, texture);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, WIDTH, HEIGHT, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, WIDTH, HEIGHT, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
 
     // Setup OpenGL para display 2D
     glMatrixMode(GL_PROJECTION);
@@ -1180,6 +1200,11 @@ int main() {
 
     Camera camera;
 
+    const int tilesX = (WIDTH + RENDER_TILE_SIZE - 1) / RENDER_TILE_SIZE;
+    const int tilesY = (HEIGHT + RENDER_TILE_SIZE - 1) / RENDER_TILE_SIZE;
+    cout << "Threads de renderizacao: " << renderPool.size()
+         << " (" << tilesX * tilesY << " tiles de " << RENDER_TILE_SIZE << "x" << RENDER_TILE_SIZE << ")\n" << endl;
+
     // Luzes (intensidades reduzidas)
     vector<Light> lights;
     // Luz da hóstia no ostensório (luz divina/sagrada)
@@ -1217,7 +1242,7 @@ int main() {
                     float distance = pickRec.t;
 
                     cout << "\n========== PICKING ==========" << endl;
-                    cout << "Objeto: " << pickRec.objectName << endl;
+                    cout << "Objeto: " << chapelObjectName(pickRec.objectId) << endl;
                     cout << "Distancia da camera: " << fixed << setprecision(2) << distance << " unidades" << endl;
                     cout << "Posicao: (" << fixed << setprecision(2)
                          << pickRec.point.x << ", "
@@ -1226,9 +1251,10 @@ int main() {
                     cout << "============================\n" << endl;
 
                     // Interatividade especial com a vela
-                    if (pickRec.objectName == "Vela (Acesa)" || pickRec.objectName == "Vela (Apagada)") {
+                    if (pickRec.objectId == candleBodyIndex) {
                         candleLit = !candleLit;
                         lights[1].enabled = candleLit;
+                        updateCandleState();
                         needsRender = true;
 
                         if (candleLit) {
@@ -1292,41 +1318,50 @@ int main() {
             }
         }
 
+        // Troca as texturas que terminaram de carregar (entre quadros)
+        if (textureLoader.pending() > 0) {
+            if (textureLoader.install() > 0) {
+                needsRender = true;
+            }
+            if (textureLoader.pending() == 0) {
+                auto loadEnd = chrono::high_resolution_clock::now();
+                cout << "✓ Carga de texturas concluida em "
+                     << chrono::duration_cast<chrono::milliseconds>(loadEnd - loadStart).count() << "ms" << endl;
+            }
+        }
+
         // Renderiza apenas se necessário
         if (needsRender) {
             needsRender = false;
 
+            // Transformações cacheadas: recalculadas só se os parâmetros mudaram
+            updateTransformCache();
+            camera.prepareRays(WIDTH, HEIGHT);
+
             cout << "Renderizando frame (CPU)..." << flush;
             auto start = chrono::high_resolution_clock::now();
 
-            // Renderização multi-thread
-            int numThreads = max(1, (int)thread::hardware_concurrency());
-            int linesPerThread = HEIGHT / numThreads;
-            vector<thread> threads;
-
-            for (int i = 0; i < numThreads; i++) {
-                int startY = i * linesPerThread;
-                int endY = (i == numThreads - 1) ? HEIGHT : (i + 1) * linesPerThread;
-
-                threads.emplace_back(renderTile, startY, endY, WIDTH, HEIGHT,
-                                   ref(framebuffer), ref(camera), ref(lights), ref(ambient));
-            }
-
-            for (auto& t : threads) t.join();
-
-            // Converte framebuffer para textura OpenGL
-            for (int i = 0; i < WIDTH * HEIGHT; i++) {
-                pixelBuffer[i * 3 + 0] = (unsigned char)(fmin(1.0, framebuffer[i].r) * 255);
-                pixelBuffer[i * 3 + 1] = (unsigned char)(fmin(1.0, framebuffer[i].g) * 255);
-                pixelBuffer[i * 3 + 2] = (unsigned char)(fmin(1.0, framebuffer[i].b) * 255);
-            }
-
+            // Renderização multi-thread: cada thread pega o próximo tile livre,
+            // então as linhas caras (altar/ostensório) não atrasam uma thread só
+            renderPool.parallelFor(tilesX * tilesY, [&](int tile) {
+                int x0 = (tile % tilesX) * RENDER_TILE_SIZE;
+                int y0 = (tile / tilesX) * RENDER_TILE_SIZE;
+                renderTile(x0, y0, min(x0 + RENDER_TILE_SIZE, WIDTH), min(y0 + RENDER_TILE_SIZE, HEIGHT),
+                           framebuffer, camera, lights, ambient);
+            });
+            auto traced = chrono::high_resolution_clock::now();
+
+            // Envia o framebuffer RGBA8 direto (sem passo de conversão)
             glBindTexture(GL_TEXTURE_2D, texture);
-            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, WIDTH, HEIGHT, GL_RGB, GL_UNSIGNED_BYTE, pixelBuffer.data());
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, (GLint)(framebuffer.rowStride() / 4));
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, WIDTH, HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, framebuffer.data());
 
             auto end = chrono::high_resolution_clock::now();
             auto duration = chrono::duration_cast<chrono::milliseconds>(end - start);
-            cout << " OK (" << duration.count() << "ms)" << endl;
+            auto traceDuration = chrono::duration_cast<chrono::milliseconds>(traced - start);
+            cout << " OK (" << duration.count() << "ms, ray tracing "
+                 << traceDuration.count() << "ms)" << endl;
         }
 
         // Display usando OpenGL (GPU apenas mostra textura)
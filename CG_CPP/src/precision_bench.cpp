@@ -0,0 +1,168 @@
+#include "../include/Vector3.h"
+#include "../include/Color.h"
+#include "../include/Material.h"
+#include "../include/Objects.h"
+#include "../include/Lights.h"
+#include "../include/Camera.h"
+#include "../include/Scene.h"
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+
+using namespace std;
+
+// BENCHMARK DE PRECISÃO
+// O mesmo código é compilado duas vezes pelo Makefile (make bench):
+//   precision_bench_double  -> Real = double, pacotes escalares (-DCG_NO_SIMD)
+//   precision_bench_float   -> Real = float,  pacotes com SSE (-DCG_USE_FLOAT)
+// e mede raios por segundo numa versão da capela montada com os objetos do
+// núcleo (planos, malhas de caixa, cilindros, esferas e cone), raio a raio
+// (traceRay) e em pacotes de PACKET_SIZE pixels (tracePacket).
+
+const int BENCH_WIDTH = 400;
+const int BENCH_HEIGHT = 300;
+const int BENCH_FRAMES = 5;
+
+// Caixa alinhada aos eixos como malha indexada: 8 vértices, 12 triângulos
+shared_ptr<Mesh> makeBoxMesh(const Vector3& mn, const Vector3& mx, const Material& mat, const string& name) {
+    auto mesh = make_shared<Mesh>(mat, name);
+    Vector3 c[8] = {
+        Vector3(mn.x, mn.y, mn.z), Vector3(mx.x, mn.y, mn.z), Vector3(mx.x, mx.y, mn.z), Vector3(mn.x, mx.y, mn.z),
+        Vector3(mn.x, mn.y, mx.z), Vector3(mx.x, mn.y, mx.z), Vector3(mx.x, mx.y, mx.z), Vector3(mn.x, mx.y, mx.z)
+    };
+    for (const auto& corner : c) {
+        mesh->addVertex(corner);
+    }
+    uint32_t faces[6][4] = {
+        {0, 3, 2, 1}, {4, 5, 6, 7},  // -z, +z
+        {0, 4, 7, 3}, {1, 2, 6, 5},  // -x, +x
+        {0, 1, 5, 4}, {3, 7, 6, 2}   // -y, +y
+    };
+    for (auto& f : faces) {
+        mesh->addTriangle(f[0], f[1], f[2]);
+        mesh->addTriangle(f[0], f[2], f[3]);
+    }
+    return mesh;
+}
+
+Scene createChapelScene() {
+    Scene scene;
+    scene.backgroundColor = Color(0.3, 0.35, 0.4);
+
+    Material matFloor(Color(0.1, 0.08, 0.06), Color(0.6, 0.5, 0.4), Color(0.1, 0.1, 0.1), 5.0);
+    Material matWall(Color(0.1, 0.1, 0.1), Color(0.7, 0.68, 0.65), Color(0.1, 0.1, 0.1), 5.0);
+    Material matWood(Color(0.1, 0.06, 0.03), Color(0.6, 0.4, 0.2), Color(0.3, 0.3, 0.3), 10.0);
+    Material matGold(Color(0.15, 0.12, 0.05), Color(0.9, 0.75, 0.3), Color(0.9, 0.9, 0.9), 50.0);
+    Material matHost(Color(0.2, 0.2, 0.2), Color(1.0, 1.0, 0.95), Color(1.0, 1.0, 1.0), 100.0);
+    Material matCandle(Color(0.1, 0.03, 0.02), Color(0.8, 0.2, 0.15), Color(0.3, 0.3, 0.3), 10.0);
+    Material matFlame(Color(0.5, 0.4, 0.0), Color(1.0, 0.8, 0.0), Color(0.1, 0.1, 0.1), 5.0);
+
+    // Capela 12 x 8 x 20
+    scene.addObject(make_shared<Plane>(Vector3(0, 0, 0), Vector3(0, 1, 0), matFloor, "Chao"));
+    scene.addObject(make_shared<Plane>(Vector3(0, 8, 0), Vector3(0, -1, 0), matWall, "Teto"));
+    scene.addObject(make_shared<Plane>(Vector3(0, 0, 20), Vector3(0, 0, -1), matWall, "Parede do Fundo"));
+    scene.addObject(make_shared<Plane>(Vector3(0, 0, 0), Vector3(1, 0, 0), matWall, "Parede Esquerda"));
+    scene.addObject(make_shared<Plane>(Vector3(12, 0, 0), Vector3(-1, 0, 0), matWall, "Parede Direita"));
+
+    scene.addObject(makeBoxMesh(Vector3(4.5, 0, 17.5), Vector3(7.5, 0.8, 18.5), matWood, "Altar"));
+    for (int i = 0; i < 4; i++) {
+        double z = 5 + i * 3.0;
+        scene.addObject(makeBoxMesh(Vector3(1.3, 0, z - 0.25), Vector3(3.7, 0.45, z + 0.25), matWood,
+                                    "Banco Esquerdo " + to_string(i + 1)));
+        scene.addObject(makeBoxMesh(Vector3(8.3, 0, z - 0.25), Vector3(10.7, 0.45, z + 0.25), matWood,
+                                    "Banco Direito " + to_string(i + 1)));
+    }
+
+    // Ostensório
+    scene.addObject(make_shared<Cylinder>(Vector3(6, 0.8, 18), 0.15, 0.3, Vector3(0, 1, 0), matGold, "Ostensorio - Base"));
+    scene.addObject(make_shared<Sphere>(Vector3(6, 1.4, 18), 0.14, matHost, "Ostensorio - Hostia"));
+    for (int i = 0; i < 8; i++) {
+        double angle = i * 2 * M_PI / 8;
+        scene.addObject(make_shared<Sphere>(Vector3(6 + 0.25 * cos(angle), 1.4 + 0.25 * sin(angle), 18), 0.025,
+                                            matGold, "Ostensorio - Raio"));
+    }
+
+    // Vela e chama
+    scene.addObject(make_shared<Cylinder>(Vector3(8, 0, 17.5), 0.12, 1.0, Vector3(0, 1, 0), matCandle, "Vela"));
+    scene.addObject(make_shared<Cone>(Vector3(8, 1.0, 17.5), 0.08, 0.3, Vector3(0, 1, 0), matFlame, "Chama da Vela"));
+
+    scene.setAmbientLight(make_shared<AmbientLight>(Color(0.15, 0.15, 0.18)));
+    scene.addLight(make_shared<PointLight>(Vector3(6, 5, 15), Color(0.7, 0.7, 0.7)));
+    scene.addLight(make_shared<PointLight>(Vector3(8, 1.4, 17.5), Color(0.5, 0.15, 0.075)));
+
+    return scene;
+}
+
+int main() {
+    cout << "========================================" << endl;
+    cout << "BENCHMARK DE PRECISAO (capela)" << endl;
+#ifdef CG_USE_FLOAT
+    cout << "Real: float (" << sizeof(Real) << " bytes)";
+#else
+    cout << "Real: double (" << sizeof(Real) << " bytes)";
+#endif
+#ifdef CG_SIMD_SSE
+    cout << ", pacotes com SSE" << endl;
+#else
+    cout << ", pacotes escalares" << endl;
+#endif
+    cout << "========================================\n" << endl;
+
+    Scene scene = createChapelScene();
+    scene.buildBVH();
+
+    Camera camera(Vector3(6, 1.8, 2), Vector3(6, 1.5, 10), Vector3(0, 1, 0),
+                  1.0, 2.0, 1.5, BENCH_WIDTH, BENCH_HEIGHT);
+    camera.setFOV(60.0);
+    CameraRayGenerator rays(camera);
+
+    // Uma thread: mede o custo dos kernels, não o escalonamento
+    double scalarSeconds = 1e30, packetSeconds = 1e30;
+    Real scalarChecksum = 0, packetChecksum = 0;
+    for (int frame = 0; frame < BENCH_FRAMES; frame++) {
+        // Raio a raio
+        auto start = chrono::steady_clock::now();
+        Color sum;
+        for (int j = 0; j < BENCH_HEIGHT; j++) {
+            for (int i = 0; i < BENCH_WIDTH; i++) {
+                sum = sum + scene.traceRay(rays.getRay(i, j));
+            }
+        }
+        auto end = chrono::steady_clock::now();
+        scalarSeconds = min(scalarSeconds, chrono::duration<double>(end - start).count());
+        scalarChecksum = sum.r + sum.g + sum.b;
+
+        // Pacotes de PACKET_SIZE pixels da mesma linha
+        start = chrono::steady_clock::now();
+        sum = Color();
+        RayPacket packet;
+        Color colors[PACKET_SIZE];
+        for (int j = 0; j < BENCH_HEIGHT; j++) {
+            for (int i = 0; i < BENCH_WIDTH; i += PACKET_SIZE) {
+                for (int lane = 0; lane < PACKET_SIZE; lane++) {
+                    packet.set(lane, rays.getRay(i + lane, j));
+                }
+                scene.tracePacket(packet, PACKET_SIZE, colors);
+                for (int lane = 0; lane < PACKET_SIZE; lane++) {
+                    sum = sum + colors[lane];
+                }
+            }
+        }
+        end = chrono::steady_clock::now();
+        packetSeconds = min(packetSeconds, chrono::duration<double>(end - start).count());
+        packetChecksum = sum.r + sum.g + sum.b;
+    }
+
+    double primaryRays = static_cast<double>(BENCH_WIDTH) * BENCH_HEIGHT;
+    cout << fixed << setprecision(2);
+    cout << "Resolucao: " << BENCH_WIDTH << "x" << BENCH_HEIGHT
+         << " (melhor de " << BENCH_FRAMES << " frames)" << endl;
+    cout << "Raio a raio:  " << scalarSeconds * 1000.0 << " ms/frame, "
+         << primaryRays / scalarSeconds / 1e6 << " M raios primarios/s (com sombras)" << endl;
+    cout << "Pacotes de " << PACKET_SIZE << ": " << packetSeconds * 1000.0 << " ms/frame, "
+         << primaryRays / packetSeconds / 1e6 << " M raios primarios/s (com sombras)" << endl;
+    cout << "Checksum da imagem: " << scalarChecksum << " / " << packetChecksum << endl;
+
+    return 0;
+}
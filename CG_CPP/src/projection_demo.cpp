@@ -56,12 +56,16 @@ int main() {
     Vector3 up(0, 1, 0);
     int resolution = 400;
 
+    // Pool de threads persistente compartilhado pelas quatro renderizações
+    auto pool = make_shared<ThreadPool>();
+    cout << "Threads de renderizacao: " << pool->size() << "\n" << endl;
+
     // ============ PROJEÇÃO PERSPECTIVA ============
     cout << "Renderizando: PROJECAO PERSPECTIVA..." << endl;
     Camera cameraPerspective(eye, at, up, 3.0, 8.0, 8.0, resolution, resolution);
     cameraPerspective.setPerspective();
 
-    Renderer rendererPersp(scene, cameraPerspective);
+    Renderer rendererPersp(scene, cameraPerspective, pool);
     rendererPersp.render("output/projecao_perspectiva.ppm");
     cout << "  ✓ Salvo: output/projecao_perspectiva.ppm\n" << endl;
 
@@ -70,7 +74,7 @@ int main() {
     Camera cameraOrtho(eye, at, up, 3.0, 8.0, 8.0, resolution, resolution);
     cameraOrtho.setOrthographic();
 
-    Renderer rendererOrtho(scene, cameraOrtho);
+    Renderer rendererOrtho(scene, cameraOrtho, pool);
     rendererOrtho.render("output/projecao_ortografica.ppm");
     cout << "  ✓ Salvo: output/projecao_ortografica.ppm\n" << endl;
 
@@ -79,7 +83,7 @@ int main() {
     Camera cameraObliqueCav(eye, at, up, 3.0, 8.0, 8.0, resolution, resolution);
     cameraObliqueCav.setOblique(45.0, 1.0);  // Cavalier: 45°, fator 1.0
 
-    Renderer rendererObliqueCav(scene, cameraObliqueCav);
+    Renderer rendererObliqueCav(scene, cameraObliqueCav, pool);
     rendererObliqueCav.render("output/projecao_obliqua_cavalier.ppm");
     cout << "  ✓ Salvo: output/projecao_obliqua_cavalier.ppm\n" << endl;
 
@@ -88,7 +92,7 @@ int main() {
     Camera cameraObliqueCab(eye, at, up, 3.0, 8.0, 8.0, resolution, resolution);
     cameraObliqueCab.setObliqueCabinet();  // Cabinet: 63.4°, fator 0.5
 
-    Renderer rendererObliqueCab(scene, cameraObliqueCab);
+    Renderer rendererObliqueCab(scene, cameraObliqueCab, pool);
     rendererObliqueCab.render("output/projecao_obliqua_cabinet.ppm");
     cout << "  ✓ Salvo: output/projecao_obliqua_cabinet.ppm\n" << endl;
 
@@ -0,0 +1,94 @@
+#include "../include/Texture.h"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// BENCHMARK DE AMOSTRAGEM DE TEXTURA
+// Mede amostras por segundo de Texture::sample no nível 0 (texel mais
+// próximo e bilinear) nas três organizações de memória (LINEAR, TILED,
+// MORTON), com três padrões de acesso:
+//   linha      -> u avança um texel por amostra (chão visto de frente)
+//   coluna     -> v avança um texel por amostra (paredes mapeadas em p.y)
+//   aleatório  -> UV sem coerência (pior caso para o cache)
+// A soma das cores tem que ser a mesma nas três organizações.
+// Uso: ./texture_bench [imagem]   (padrão: textures/wood.jpg)
+
+const int BENCH_SAMPLES = 4000000;
+
+struct UV {
+    double u, v;
+};
+
+vector<UV> makePattern(const string& pattern, int width, int height) {
+    vector<UV> uvs(BENCH_SAMPLES);
+    uint32_t state = 12345;  // xorshift: mesma sequência em todas as execuções
+
+    for (int i = 0; i < BENCH_SAMPLES; i++) {
+        if (pattern == "linha") {
+            int x = i % width;
+            int y = (i / width) % height;
+            uvs[i] = {(x + 0.3) / width, 1.0 - (y + 0.6) / height};
+        } else if (pattern == "coluna") {
+            int y = i % height;
+            int x = (i / height) % width;
+            uvs[i] = {(x + 0.3) / width, 1.0 - (y + 0.6) / height};
+        } else {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            double u = (state & 0xffff) / 65536.0;
+            double v = (state >> 16) / 65536.0;
+            uvs[i] = {u, v};
+        }
+    }
+    return uvs;
+}
+
+int main(int argc, char** argv) {
+    string filename = argc > 1 ? argv[1] : "textures/wood.jpg";
+
+    Texture texture;
+    if (!texture.load(filename, TextureLayout::LINEAR)) {
+        return 1;
+    }
+
+    const char* patterns[] = {"linha", "coluna", "aleatório"};
+    const TextureLayout layouts[] = {TextureLayout::LINEAR, TextureLayout::TILED, TextureLayout::MORTON};
+    const char* layoutNames[] = {"LINEAR", "TILED", "MORTON"};
+    const TextureFilter filters[] = {TextureFilter::NEAREST, TextureFilter::BILINEAR};
+    const char* filterNames[] = {"nearest", "bilinear"};
+
+    cout << "\nAmostras por padrão: " << BENCH_SAMPLES << endl;
+    cout << left << setw(12) << "padrão" << setw(10) << "filtro" << setw(10) << "layout"
+         << right << setw(12) << "Mamostras/s" << setw(16) << "soma" << endl;
+
+    for (const char* pattern : patterns) {
+        vector<UV> uvs = makePattern(pattern, texture.getWidth(), texture.getHeight());
+
+        for (int f = 0; f < 2; f++) {
+            for (int l = 0; l < 3; l++) {
+                texture.setLayout(layouts[l]);
+
+                double sum = 0.0;
+                auto start = chrono::high_resolution_clock::now();
+                for (const UV& uv : uvs) {
+                    Color c = texture.sample(uv.u, uv.v, 0.0, filters[f]);
+                    sum += c.r + c.g + c.b;
+                }
+                auto end = chrono::high_resolution_clock::now();
+                double seconds = chrono::duration<double>(end - start).count();
+
+                cout << left << setw(12) << pattern << setw(10) << filterNames[f] << setw(10) << layoutNames[l]
+                     << right << fixed << setprecision(1) << setw(12) << BENCH_SAMPLES / seconds / 1e6
+                     << setprecision(2) << setw(16) << sum << endl;
+            }
+        }
+    }
+
+    return 0;
+}